@@ -219,7 +219,11 @@ set(SGAMELIST
     ${GAMELOGIC_DIR}/sgame/sg_definitions.h
     ${GAMELOGIC_DIR}/sgame/sg_entities.cpp
     ${GAMELOGIC_DIR}/sgame/sg_entities.h
+    ${GAMELOGIC_DIR}/sgame/sg_events.cpp
+    ${GAMELOGIC_DIR}/sgame/sg_events.h
     ${GAMELOGIC_DIR}/sgame/sg_extern.h
+    ${GAMELOGIC_DIR}/sgame/sg_hostiles.cpp
+    ${GAMELOGIC_DIR}/sgame/sg_hostiles.h
     ${GAMELOGIC_DIR}/sgame/sg_local.h
     ${GAMELOGIC_DIR}/sgame/sg_main.cpp
     ${GAMELOGIC_DIR}/sgame/sg_map_entity.h
@@ -229,6 +233,8 @@ set(SGAMELIST
     ${GAMELOGIC_DIR}/sgame/sg_namelog.cpp
     ${GAMELOGIC_DIR}/sgame/sg_physics.cpp
     ${GAMELOGIC_DIR}/sgame/sg_public.h
+    ${GAMELOGIC_DIR}/sgame/sg_service.cpp
+    ${GAMELOGIC_DIR}/sgame/sg_service.h
     ${GAMELOGIC_DIR}/sgame/sg_session.cpp
     ${GAMELOGIC_DIR}/sgame/sg_spawn.cpp
     ${GAMELOGIC_DIR}/sgame/sg_spawn.h
@@ -341,6 +347,8 @@ set(SGAMELIST
     ${GAMELOGIC_DIR}/sgame/components/TurretComponent.cpp
     ${GAMELOGIC_DIR}/sgame/components/TurretComponent.h
 
+    ${GAMELOGIC_DIR}/sgame/lua/EntityQuery.cpp
+    ${GAMELOGIC_DIR}/sgame/lua/EntityQuery.h
     ${GAMELOGIC_DIR}/sgame/lua/Interpreter.cpp
     ${GAMELOGIC_DIR}/sgame/lua/Interpreter.h
 
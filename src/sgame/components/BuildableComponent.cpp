@@ -12,6 +12,12 @@ BuildableComponent::BuildableComponent(Entity& entity, HealthComponent& r_Health
 
 	// TODO: Make power state a member variable.
 	entity.oldEnt->powered = true;
+
+	G_InvalidateBuildablePowerStates();
+}
+
+BuildableComponent::~BuildableComponent() {
+	G_InvalidateBuildablePowerStates();
 }
 
 void BuildableComponent::HandlePrepareNetCode() {
@@ -53,6 +59,8 @@ void BuildableComponent::HandleDie(gentity_t* killer, meansOfDeath_t meansOfDeat
 
 	TeamComponent::team_t team = GetTeamComponent().Team();
 
+	G_InvalidateBuildablePowerStates();
+
 	// TODO: Move animation code to BuildableComponent.
 	G_SetBuildableAnim(entity.oldEnt, Powered() ? BANIM_DESTROY : BANIM_DESTROY_UNPOWERED, true);
 	G_SetIdleBuildableAnim(entity.oldEnt, BANIM_DESTROYED);
@@ -160,6 +168,8 @@ void BuildableComponent::SetPowerState(bool powered) {
 
 	entity.oldEnt->powered = powered;
 
+	G_InvalidateBuildablePowerStates();
+
 	if (powered && !wasPowered) {
 		G_SetBuildableAnim(entity.oldEnt, BANIM_POWERUP, false);
 		G_SetIdleBuildableAnim(entity.oldEnt, BANIM_IDLE1);
@@ -29,6 +29,8 @@ class BuildableComponent: public BuildableComponentBase {
 		 */
 		BuildableComponent(Entity& entity, HealthComponent& r_HealthComponent, ThinkingComponent& r_ThinkingComponent, TeamComponent& r_TeamComponent);
 
+		~BuildableComponent();
+
 		/**
 		 * @brief Handle the PrepareNetCode message.
 		 * @note This method is an interface for autogenerated code, do not modify its signature.
@@ -60,9 +62,9 @@ class BuildableComponent: public BuildableComponentBase {
 		 */
 		int  GetMarkTime() const { return marked ? markTime : 0; }
 
-		void SetDeconstructionMark() { marked = true; markTime = level.time; }
-		void ClearDeconstructionMark() { marked = false; }
-		void ToggleDeconstructionMark() { marked = !marked; if (marked) markTime = level.time; }
+		void SetDeconstructionMark() { marked = true; markTime = level.time; G_InvalidateBuildablePowerStates(); }
+		void ClearDeconstructionMark() { marked = false; G_InvalidateBuildablePowerStates(); }
+		void ToggleDeconstructionMark() { marked = !marked; if (marked) markTime = level.time; G_InvalidateBuildablePowerStates(); }
 
 		/**
 		 * @brief Change the buildable's power state.
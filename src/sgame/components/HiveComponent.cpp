@@ -2,6 +2,7 @@
 #include "HiveComponent.h"
 #include "../Entities.h"
 #include "../CBSE.h"
+#include "../sg_hostiles.h"
 
 #include <glm/geometric.hpp>
 constexpr int   ATTACK_PERIOD = 3000;
@@ -54,15 +55,15 @@ void HiveComponent::Think(int /*timeDelta*/) {
 Entity* HiveComponent::FindTarget() {
 	Entity* target = nullptr;
 
-	ForEntities<HumanClassComponent>([&](Entity& candidate, HumanClassComponent&) {
+	for (Entity* candidate : G_HostileClients(G_Team(entity.oldEnt), VEC2GLM(entity.oldEnt->s.origin), HIVE_SENSE_RANGE)) {
 		// Check if target is valid and in sense range.
-		if (!TargetValid(candidate, true)) return;
+		if (!TargetValid(*candidate, true)) continue;
 
 		// Check if better target.
-		if (!target || CompareTargets(candidate, *target)) {
-			target = &candidate;
+		if (!target || CompareTargets(*candidate, *target)) {
+			target = candidate;
 		}
-	});
+	}
 
 	return target;
 }
@@ -82,7 +83,7 @@ bool HiveComponent::TargetValid(Entity& candidate, bool checkDistance) const {
 	if (checkDistance && G_Distance(entity.oldEnt, candidate.oldEnt) > HIVE_SENSE_RANGE) return false;
 
 	// Check for line of sight.
-	if (!G_LineOfFire(entity.oldEnt, candidate.oldEnt)) return false;
+	if (!G_CachedLineOfFire(entity.oldEnt, candidate.oldEnt)) return false;
 
 	return true;
 }
@@ -34,10 +34,25 @@ const int   IgnitableComponent::BASE_AVERAGE_BURN_TIME  = 8000;
 const int   IgnitableComponent::EXTRA_AVERAGE_BURN_TIME = 5000;
 const float IgnitableComponent::EXTRA_BURN_TIME_RADIUS  = 150.0f;
 const float IgnitableComponent::SPREAD_RADIUS           = 120.0f;
+const float IgnitableComponent::NEIGHBOUR_RADIUS        = 182.0f;
 
 static_assert(IgnitableComponent::BASE_AVERAGE_BURN_TIME > IgnitableComponent::MIN_BURN_TIME,
               "Average burn time needs to be greater than minimum burn time.");
 
+// Ignitables are linked into a neighbour graph so that burning entities don't need to look at
+// every other ignitable whenever they consider stopping or spreading. Entities are linked lazily
+// on the first update after their creation, relinked once per frame when they moved and unlinked
+// on destruction.
+static std::vector<IgnitableComponent*> linkedIgnitables;
+static std::vector<IgnitableComponent*> pendingIgnitables;
+static int graphUpdateTime = -1;
+
+// Neighbours are kept in the order ForEntities visits components, which is the order
+// random numbers were drawn in before the graph existed.
+static bool NeighbourOrder(const IgnitableComponent *a, const IgnitableComponent *b) {
+	return std::less<const IgnitableComponent*>()(a, b);
+}
+
 IgnitableComponent::IgnitableComponent(Entity& entity, bool alwaysOnFire, ThinkingComponent& r_ThinkingComponent)
 	: IgnitableComponentBase(entity, alwaysOnFire, r_ThinkingComponent)
 	, onFire(alwaysOnFire)
@@ -45,13 +60,99 @@ IgnitableComponent::IgnitableComponent(Entity& entity, bool alwaysOnFire, Thinki
 	, immuneUntil(0)
 	, spreadAt(INT_MAX)
 	, fireStarter(nullptr)
-	, normalDistribution(0.0f, (float)BASE_AVERAGE_BURN_TIME) {
+	, normalDistribution(0.0f, (float)BASE_AVERAGE_BURN_TIME)
+	, linked(false) {
+	pendingIgnitables.push_back(this);
+
 	REGISTER_THINKER(DamageSelf, ThinkingComponent::SCHEDULER_AVERAGE, 100);
 	REGISTER_THINKER(DamageArea, ThinkingComponent::SCHEDULER_AVERAGE, 100);
 	REGISTER_THINKER(ConsiderStop, ThinkingComponent::SCHEDULER_AVERAGE, 500);
 	REGISTER_THINKER(ConsiderSpread, ThinkingComponent::SCHEDULER_AVERAGE, 500);
 }
 
+IgnitableComponent::~IgnitableComponent() {
+	if (linked) {
+		Unlink();
+	} else {
+		pendingIgnitables.erase(std::remove(pendingIgnitables.begin(), pendingIgnitables.end(), this),
+		                        pendingIgnitables.end());
+	}
+}
+
+void IgnitableComponent::LinkPending() {
+	// Linking can't add to the pending list, but swap it out to be safe.
+	std::vector<IgnitableComponent*> pending;
+	std::swap(pending, pendingIgnitables);
+
+	for (IgnitableComponent *ignitable : pending) {
+		ignitable->Link();
+	}
+}
+
+void IgnitableComponent::Link() {
+	ASSERT(!linked);
+
+	VectorCopy(entity.oldEnt->s.origin, linkedOrigin);
+
+	neighbours.clear();
+
+	for (IgnitableComponent *other : linkedIgnitables) {
+		if (Distance(linkedOrigin, other->entity.oldEnt->s.origin) > NEIGHBOUR_RADIUS) continue;
+
+		neighbours.push_back(other);
+
+		auto &otherNeighbours = other->neighbours;
+		otherNeighbours.insert(std::upper_bound(otherNeighbours.begin(), otherNeighbours.end(),
+		                                        this, NeighbourOrder), this);
+	}
+
+	std::sort(neighbours.begin(), neighbours.end(), NeighbourOrder);
+
+	linkedIgnitables.push_back(this);
+	linked = true;
+
+	fireLogger.Debug("Linked into the neighbour graph with %i neighbours.", neighbours.size());
+}
+
+void IgnitableComponent::Unlink() {
+	ASSERT(linked);
+
+	for (IgnitableComponent *other : neighbours) {
+		auto &otherNeighbours = other->neighbours;
+		otherNeighbours.erase(std::remove(otherNeighbours.begin(), otherNeighbours.end(), this),
+		                      otherNeighbours.end());
+	}
+
+	neighbours.clear();
+
+	linkedIgnitables.erase(std::remove(linkedIgnitables.begin(), linkedIgnitables.end(), this),
+	                       linkedIgnitables.end());
+	linked = false;
+}
+
+void IgnitableComponent::UpdateNeighbours() {
+	LinkPending();
+
+	if (level.time == graphUpdateTime) return;
+
+	graphUpdateTime = level.time;
+
+	// Relink everything that moved, not just this ignitable, so that a falling neighbour can't
+	// outrun the slack in NEIGHBOUR_RADIUS.
+	std::vector<IgnitableComponent*> moved;
+
+	for (IgnitableComponent *ignitable : linkedIgnitables) {
+		if (!VectorCompare(ignitable->linkedOrigin, ignitable->entity.oldEnt->s.origin)) {
+			moved.push_back(ignitable);
+		}
+	}
+
+	for (IgnitableComponent *ignitable : moved) {
+		ignitable->Unlink();
+		ignitable->Link();
+	}
+}
+
 void IgnitableComponent::HandlePrepareNetCode() {
 	if (onFire) {
 		entity.oldEnt->s.eFlags |= EF_B_ONFIRE;
@@ -146,6 +247,8 @@ void IgnitableComponent::DamageArea(int timeDelta) {
 }
 
 void IgnitableComponent::ConsiderStop(int timeDelta) {
+	UpdateNeighbours();
+
 	if (!onFire) return;
 
 	// Don't stop freshly (re-)ignited fires.
@@ -163,20 +266,19 @@ void IgnitableComponent::ConsiderStop(int timeDelta) {
 	float averagePostMinBurnTime = BASE_AVERAGE_BURN_TIME - MIN_BURN_TIME;
 
 	// Increase average burn time dynamically for burning entities in range.
-	ForEntities<IgnitableComponent>([&](Entity &other, IgnitableComponent &ignitable){
-		if (&other == &entity) return;
-		if (!ignitable.onFire) return;
+	for (IgnitableComponent *ignitable : neighbours) {
+		if (!ignitable->onFire) continue;
 
 		// TODO: Use LocationComponent.
-		float distance = G_Distance(other.oldEnt, entity.oldEnt);
+		float distance = G_Distance(ignitable->entity.oldEnt, entity.oldEnt);
 
-		if (distance > EXTRA_BURN_TIME_RADIUS) return;
+		if (distance > EXTRA_BURN_TIME_RADIUS) continue;
 
 		float distanceFrac = distance / EXTRA_BURN_TIME_RADIUS;
 		float distanceMod  = 1.0f - distanceFrac;
 
 		averagePostMinBurnTime += EXTRA_AVERAGE_BURN_TIME * distanceMod;
-	});
+	}
 
 	// The burn stop chance follows an exponential distribution.
 	float lambda = 1.0f / averagePostMinBurnTime;
@@ -198,21 +300,26 @@ void IgnitableComponent::ConsiderStop(int timeDelta) {
 }
 
 void IgnitableComponent::ConsiderSpread(int /*timeDelta*/) {
+	UpdateNeighbours();
+
 	if (!onFire) return;
 	if (level.time < spreadAt) return;
 
 	fireLogger.Notice("Trying to spread.");
 
-	ForEntities<IgnitableComponent>([&](Entity &other, IgnitableComponent &ignitable){
-		if (&other == &entity) return;
+	// Igniting a neighbour can't change the graph, but iterate over a copy to be safe.
+	std::vector<IgnitableComponent*> candidates = neighbours;
 
+	for (IgnitableComponent *ignitable : candidates) {
 		// Don't re-ignite.
-		if (ignitable.onFire) return;
+		if (ignitable->onFire) continue;
+
+		Entity &other = ignitable->entity;
 
 		// TODO: Use LocationComponent.
 		float distance = G_Distance(other.oldEnt, entity.oldEnt);
 
-		if (distance > SPREAD_RADIUS) return;
+		if (distance > SPREAD_RADIUS) continue;
 
 		float distanceFrac = distance / SPREAD_RADIUS;
 		float distanceMod  = 1.0f - distanceFrac;
@@ -224,7 +331,7 @@ void IgnitableComponent::ConsiderSpread(int /*timeDelta*/) {
 				                  spreadChance*100.0f);
 			}
 		}
-	});
+	}
 
 	// Don't spread again until re-ignited.
 	spreadAt = INT_MAX;
@@ -50,6 +50,10 @@ class IgnitableComponent: public IgnitableComponentBase {
 		/** The radius in which fire can spread. */
 		const static float SPREAD_RADIUS;
 
+		/** The radius in which other ignitables are tracked as neighbours. Includes some slack
+		 *  so that neighbours drifting slightly are still considered. */
+		const static float NEIGHBOUR_RADIUS;
+
 		// ///////////////////// //
 		// Autogenerated Members //
 		// ///////////////////// //
@@ -63,6 +67,8 @@ class IgnitableComponent: public IgnitableComponentBase {
 		 */
 		IgnitableComponent(Entity& entity, bool alwaysOnFire, ThinkingComponent& r_ThinkingComponent);
 
+		~IgnitableComponent();
+
 		/**
 		 * @brief Handle the PrepareNetCode message.
 		 * @note This method is an interface for autogenerated code, do not modify its signature.
@@ -91,6 +97,22 @@ class IgnitableComponent: public IgnitableComponentBase {
 		void ConsiderSpread(int timeDelta);
 
 	private:
+		/** Makes sure the neighbour graph is up to date, relinking ignitables that moved. */
+		void UpdateNeighbours();
+
+		/** Adds this ignitable to the neighbour graph. */
+		void Link();
+
+		/** Removes this ignitable from the neighbour graph. */
+		void Unlink();
+
+		/** Links all ignitables that were created since the last update. */
+		static void LinkPending();
+
+		std::vector<IgnitableComponent*> neighbours; /**< Ignitables in NEIGHBOUR_RADIUS, in component address order like ForEntities. */
+		bool linked;            /**< Whether this ignitable is part of the neighbour graph. */
+		vec3_t linkedOrigin;    /**< Origin at the time of linking. */
+
 		bool onFire;
 		int igniteTime;         /**< Time of (re-)ignition. */
 		int immuneUntil;        /**< Fire immunity time after being extinguished. */
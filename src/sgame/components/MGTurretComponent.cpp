@@ -1,5 +1,6 @@
 #include "common/Common.h"
 #include "MGTurretComponent.h"
+#include "../sg_hostiles.h"
 
 #include <glm/geometric.hpp>
 
@@ -76,7 +77,7 @@ void MGTurretComponent::Think(int timeDelta) {
 		// Shoot as soon as the target can be hit.
 		if (GetTurretComponent().TargetCanBeHit()) {
 			// If the target origin is visible, aim for it first.
-			if (G_LineOfFire(entity.oldEnt, GetTurretComponent().GetTarget()->oldEnt)) {
+			if (G_CachedLineOfFire(entity.oldEnt, GetTurretComponent().GetTarget()->oldEnt)) {
 				GetTurretComponent().MoveHeadToTarget(timeDelta);
 			}
 
@@ -101,8 +102,8 @@ bool MGTurretComponent::CompareTargets(const glm::vec3& aimDirection, Entity& a,
 	// Prefer the target that is in a line of sight.
 	// This prevents the turret from keeping a lock on a target behind cover when there is another
 	// enemy in reach that is not yet targeted.
-	bool canSeeA = G_LineOfFire(entity.oldEnt, a.oldEnt);
-	bool canSeeB = G_LineOfFire(entity.oldEnt, b.oldEnt);
+	bool canSeeA = G_CachedLineOfFire(entity.oldEnt, a.oldEnt);
+	bool canSeeB = G_CachedLineOfFire(entity.oldEnt, b.oldEnt);
 
 	if        ( canSeeA && !canSeeB) {
 		return true;
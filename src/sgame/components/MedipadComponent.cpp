@@ -26,6 +26,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "common/Common.h"
 #include "MedipadComponent.h"
 #include "sgame/Entities.h"
+#include "sgame/sg_service.h"
 
 MedipadComponent::MedipadComponent(Entity& entity, HumanBuildableComponent& r_HumanBuildableComponent)
 	: MedipadComponentBase(entity, r_HumanBuildableComponent)
@@ -48,7 +49,6 @@ gentity_t* MedipadComponent::GetTarget() const
 
 void MedipadComponent::Think(int timeDelta)
 {
-	int       entityList[MAX_GENTITIES];
 	vec3_t    mins, maxs;
 	gentity_t* self = entity.oldEnt;
 
@@ -75,25 +75,24 @@ void MedipadComponent::Think(int timeDelta)
 	// (ignoring reference invalidation).
 	bool medistationWasHealing = target_.entity != nullptr;
 
-	// get entities standing on top
-	VectorAdd(self->s.origin, self->r.maxs, maxs);
-	VectorAdd(self->s.origin, self->r.mins, mins);
+	// get players standing on top
+	G_ServiceArea(self, mins, maxs);
 
-	mins[2] += (self->r.mins[2] + self->r.maxs[2]);
-	maxs[2] += 32; // continue to heal jumping players but don't heal jetpack campers
-
-	int numPlayers = trap_EntitiesInBox(mins, maxs, entityList, MAX_GENTITIES);
 	gentity_t* oldTarget = target_.get();
 	gentity_t* newTarget = nullptr;
 
 	// clear poison, distribute medikits, find a new target if necessary
-	for (int playerNum = 0; playerNum < numPlayers; playerNum++)
+	for (gentity_t* player : G_ServiceOccupants(self))
 	{
-		gentity_t* player = &g_entities[entityList[playerNum]];
 		gclient_t* client = player->client;
 
 		// only react to humans
-		if (!client || client->pers.team != TEAM_HUMANS)
+		if (!player->inuse || !client || client->pers.team != TEAM_HUMANS)
+		{
+			continue;
+		}
+
+		if (!BoundsIntersect(mins, maxs, player->r.absmin, player->r.absmax))
 		{
 			continue;
 		}
@@ -2,9 +2,30 @@
 #include "MiningComponent.h"
 #include "../Entities.h"
 
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+// Miners by grid cell. The cells are as large as the interference range, so that all miners
+// that can interfere with a location are in the 27 cells around it.
+struct CellHash {
+	size_t operator()(const glm::ivec3& cell) const {
+		return std::hash<int>()(cell.x) ^ (std::hash<int>()(cell.y) << 1) ^ (std::hash<int>()(cell.z) << 2);
+	}
+};
+
+std::unordered_map<glm::ivec3, std::vector<MiningComponent*>, CellHash> minerGrid;
+
+glm::ivec3 CellOf(const glm::vec3& location) {
+	return glm::ivec3(glm::floor(location / (2.0f * RGS_RANGE)));
+}
+}
+
 MiningComponent::MiningComponent(Entity& entity, ThinkingComponent& r_ThinkingComponent)
 	: MiningComponentBase(entity, r_ThinkingComponent)
-	, active(false) {
+	, active(false)
+	, cell(CellOf(VEC2GLM(entity.oldEnt->s.origin))) {
+	minerGrid[cell].push_back(this);
 
 	// Already calculate the predicted efficiency.
 	CalculateEfficiency();
@@ -13,7 +34,35 @@ MiningComponent::MiningComponent(Entity& entity, ThinkingComponent& r_ThinkingCo
 	InformNeighbors();
 }
 
+MiningComponent::~MiningComponent() {
+	std::vector<MiningComponent*>& miners = minerGrid[cell];
+	miners.erase(std::find(miners.begin(), miners.end(), this));
+
+	if (miners.empty()) {
+		minerGrid.erase(cell);
+	}
+}
+
+void MiningComponent::UpdateCell() {
+	glm::ivec3 newCell = CellOf(VEC2GLM(entity.oldEnt->s.origin));
+
+	if (newCell == cell) return;
+
+	std::vector<MiningComponent*>& miners = minerGrid[cell];
+	miners.erase(std::find(miners.begin(), miners.end(), this));
+
+	if (miners.empty()) {
+		minerGrid.erase(cell);
+	}
+
+	cell = newCell;
+	minerGrid[cell].push_back(this);
+}
+
 void MiningComponent::HandlePrepareNetCode() {
+	// Buildables can fall, so keep the grid up to date.
+	UpdateCell();
+
 	// Mining efficiency.
 	entity.oldEnt->s.weaponAnim = (int)std::round(Efficiency() * (float)0xff);
 
@@ -67,11 +116,16 @@ MiningComponent::Efficiencies MiningComponent::FindEfficiencies(
 {
 	MiningComponent::Efficiencies efficiencies{ 1.0f, 1.0f };
 
-	ForEntities<MiningComponent>([&](Entity& other, MiningComponent& miningComponent) {
-		if (&miningComponent == skip) return;
+	// Miners out of range would multiply by exactly 1, so skipping them doesn't change the
+	// result as long as the others are multiplied in the same order.
+	for (MiningComponent* neighbor : FindNeighbors(location)) {
+		MiningComponent& miningComponent = *neighbor;
+		Entity& other = miningComponent.entity;
+
+		if (&miningComponent == skip) continue;
 
 		// Do not consider dead neighbours, even when predicting, as they can never become active.
-		if (!Entities::IsAlive(other)) return;
+		if (!Entities::IsAlive(other)) continue;
 
 		float interferenceMod = InterferenceMod(glm::distance(location, VEC2GLM(other.oldEnt->s.origin)));
 
@@ -83,10 +137,32 @@ MiningComponent::Efficiencies MiningComponent::FindEfficiencies(
 		if (miningComponent.active) {
 			efficiencies.actual *= interferenceMod;
 		}
-	});
+	}
 	return efficiencies;
 }
 
+std::vector<MiningComponent*> MiningComponent::FindNeighbors(const glm::vec3& location) {
+	std::vector<MiningComponent*> neighbors;
+	glm::ivec3 center = CellOf(location);
+
+	for (int x = center.x - 1; x <= center.x + 1; x++) {
+		for (int y = center.y - 1; y <= center.y + 1; y++) {
+			for (int z = center.z - 1; z <= center.z + 1; z++) {
+				auto it = minerGrid.find(glm::ivec3(x, y, z));
+
+				if (it != minerGrid.end()) {
+					neighbors.insert(neighbors.end(), it->second.begin(), it->second.end());
+				}
+			}
+		}
+	}
+
+	// ForEntities goes through the components in pointer order.
+	std::sort(neighbors.begin(), neighbors.end(), std::less<MiningComponent*>());
+
+	return neighbors;
+}
+
 void MiningComponent::CalculateEfficiency() {
 	Efficiencies efficiencies = FindEfficiencies(
 		G_Team(entity.oldEnt), VEC2GLM(entity.oldEnt->s.origin), this);
@@ -95,12 +171,12 @@ void MiningComponent::CalculateEfficiency() {
 }
 
 void MiningComponent::InformNeighbors() {
-	ForEntities<MiningComponent>([&] (Entity& other, MiningComponent& miningComponent) {
-		if (&other == &entity) return;
-		if (G_Distance(entity.oldEnt, other.oldEnt) > RGS_RANGE * 2.0f) return;
+	for (MiningComponent* neighbor : FindNeighbors(VEC2GLM(entity.oldEnt->s.origin))) {
+		if (neighbor == this) continue;
+		if (G_Distance(entity.oldEnt, neighbor->entity.oldEnt) > RGS_RANGE * 2.0f) continue;
 
-		miningComponent.CalculateEfficiency();
-	});
+		neighbor->CalculateEfficiency();
+	}
 }
 
 float MiningComponent::Efficiency(bool predict) {
@@ -18,6 +18,8 @@ class MiningComponent: public MiningComponentBase {
 		 */
 		MiningComponent(Entity& entity, ThinkingComponent& r_ThinkingComponent);
 
+		~MiningComponent();
+
 		/**
 		 * @brief Handle the PrepareNetCode message.
 		 * @note This method is an interface for autogenerated code, do not modify its signature.
@@ -57,6 +59,12 @@ class MiningComponent: public MiningComponentBase {
 		 */
 		static Efficiencies FindEfficiencies(team_t team, const glm::vec3& location, MiningComponent* skip);
 
+		/**
+		 * @return All miners that might be within interference range (2 * RGS_RANGE) of the
+		 *         location, in the order ForEntities<MiningComponent> visits them.
+		 */
+		static std::vector<MiningComponent*> FindNeighbors(const glm::vec3& location);
+
 		/**
 		 * @param predict Whether to assume that the miner and its non-dead neighbors are active.
 		 * @return The current or potential (if predicting) efficiency of this miner.
@@ -85,6 +93,16 @@ class MiningComponent: public MiningComponentBase {
 		 */
 		float predictedEfficiency;
 
+		/**
+		 * @brief Cell of the miner grid this miner is filed under.
+		 */
+		glm::ivec3 cell;
+
+		/**
+		 * @brief Files the miner under the grid cell of its current origin.
+		 */
+		void UpdateCell();
+
 		/**
 		 * @brief Adjust the current and calculates the predicted mining efficiency.
 		 */
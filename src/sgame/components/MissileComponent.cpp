@@ -153,6 +153,40 @@ void MissileComponent::Move(int)
 	dead_ = MoveMissile(entity.oldEnt);
 }
 
+void MissileComponent::BeginMoves()
+{
+	vec3_t mins, maxs;
+	bool any = false;
+
+	// Bound every missile's move this frame, as G_CM_Trace would for each of them.
+	ForEntities<MissileComponent>([&](Entity& entity, MissileComponent& missile) {
+		if (missile.dead_) return;
+
+		const gentity_t* ent = entity.oldEnt;
+		vec3_t origin;
+		BG_EvaluateTrajectory(&ent->s.pos, level.time, origin);
+
+		for (int i = 0; i < 3; i++) {
+			float lo = std::min(ent->r.currentOrigin[i], origin[i]) + std::min(ent->r.mins[i], 0.0f) - 1.0f;
+			float hi = std::max(ent->r.currentOrigin[i], origin[i]) + std::max(ent->r.maxs[i], 0.0f) + 1.0f;
+
+			mins[i] = any ? std::min(mins[i], lo) : lo;
+			maxs[i] = any ? std::max(maxs[i], hi) : hi;
+		}
+
+		any = true;
+	});
+
+	if (any) {
+		G_CM_BeginTraceArea(mins, maxs);
+	}
+}
+
+void MissileComponent::EndMoves()
+{
+	G_CM_EndTraceArea();
+}
+
 void MissileComponent::Steer(int)
 {
 	if (dead_) return;
@@ -58,6 +58,17 @@ class MissileComponent: public MissileComponentBase {
 
 		const missileAttributes_t& Attributes() const { return ma_; }
 
+		/**
+		 * @brief Looks up the entities around all of this frame's missile moves at once, so
+		 *        that each missile's traces only filter that list instead of searching the world.
+		 */
+		static void BeginMoves();
+
+		/**
+		 * @brief Ends the lookup shared by BeginMoves.
+		 */
+		static void EndMoves();
+
 	private:
 		void Move(int timeDelta);
 		void Expire(int timeDelta);
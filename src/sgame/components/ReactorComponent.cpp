@@ -23,14 +23,14 @@ void ReactorComponent::Think(int timeDelta) {
 		// Respect the no-target flag.
 		if (other.oldEnt->flags & FL_NOTARGET) return;
 
-		// Don't zap through walls
-		if ( !G_LineOfSight( entity.oldEnt, other.oldEnt, MASK_SOLID, false ) ) return;
-
 		// TODO: Add LocationComponent and Utility::BBOXDistance.
 		float distance = G_Distance(entity.oldEnt, other.oldEnt);
 
 		if (distance >= ATTACK_RANGE) return;
 
+		// Don't zap through walls, only checked in range as it traces.
+		if ( !G_LineOfSight( entity.oldEnt, other.oldEnt, MASK_SOLID, false ) ) return;
+
 		float damage = baseDamage * (1.0f - (0.7f * distance / ATTACK_RANGE));
 
 		CreateTeslaTrail(other);
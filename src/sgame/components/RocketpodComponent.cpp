@@ -2,6 +2,7 @@
 #include "RocketpodComponent.h"
 #include "../Entities.h"
 #include "../CBSE.h"
+#include "../sg_hostiles.h"
 
 #include <glm/geometric.hpp>
 
@@ -120,7 +121,7 @@ void RocketpodComponent::Think(int timeDelta) {
 
 		if (GetTurretComponent().TargetCanBeHit()) {
 			// If the target origin is visible, aim for it first.
-			if (G_LineOfFire(entity.oldEnt, GetTurretComponent().GetTarget()->oldEnt)) {
+			if (G_CachedLineOfFire(entity.oldEnt, GetTurretComponent().GetTarget()->oldEnt)) {
 				GetTurretComponent().MoveHeadToTarget(timeDelta);
 			}
 
@@ -164,8 +165,8 @@ bool RocketpodComponent::CompareTargets(Entity &a, Entity &b) {
 	// Prefer the target that is in a line of sight.
 	// This prevents the turret from keeping a lock on a target behind cover when there is another
 	// enemy in reach that is not yet targeted.
-	bool canSeeA = G_LineOfFire(entity.oldEnt, a.oldEnt);
-	bool canSeeB = G_LineOfFire(entity.oldEnt, b.oldEnt);
+	bool canSeeA = G_CachedLineOfFire(entity.oldEnt, a.oldEnt);
+	bool canSeeB = G_CachedLineOfFire(entity.oldEnt, b.oldEnt);
 
 	if        ( canSeeA && !canSeeB) {
 		return true;
@@ -222,14 +223,12 @@ bool RocketpodComponent::SafeShot(int passEntityNumber, const glm::vec3& origin,
 bool RocketpodComponent::EnemyClose() {
 	const missileAttributes_t* missileAttributes = BG_Missile(MIS_ROCKET);
 
-	bool enemyClose = false;
+	for (Entity* candidate : G_HostileClients(G_Team(entity.oldEnt), VEC2GLM(entity.oldEnt->s.origin), FLT_MAX)) {
+		Entity& other = *candidate;
 
-	ForEntities<ClientComponent>([&](Entity& other, ClientComponent&) {
-		if (enemyClose) return;
-
-		if (other.Get<SpectatorComponent>()) return;
-		if (Entities::IsDead(other)) return;
-		if (!Entities::OnOpposingTeams(entity, other)) return;
+		if (other.Get<SpectatorComponent>()) continue;
+		if (Entities::IsDead(other)) continue;
+		if (!Entities::OnOpposingTeams(entity, other)) continue;
 
 		float distance = G_Distance(entity.oldEnt, other.oldEnt);
 
@@ -252,11 +251,11 @@ bool RocketpodComponent::EnemyClose() {
 		float safetyDistance = splashRadius + turretRadius;
 
 		if (closestExplosionCenter < safetyDistance) {
-			enemyClose = true;
+			return true;
 		}
-	});
+	}
 
-	return enemyClose;
+	return false;
 }
 
 void RocketpodComponent::Shoot(const glm::vec3& direction) {
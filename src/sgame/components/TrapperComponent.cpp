@@ -26,6 +26,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "common/Common.h"
 #include "TrapperComponent.h"
 #include "sgame/Entities.h"
+#include "sgame/sg_hostiles.h"
 
 #define TRAPPER_ACCURACY 10 // lower is better
 
@@ -148,16 +149,22 @@ static bool ATrapper_CheckTarget(gentity_t* self, gentity_t* target)
 
 static gentity_t* ATrapper_FindEnemy(gentity_t* ent)
 {
-	int       i;
-	int       start;
+	// only look at the enemies in range
+	std::vector<Entity*> candidates = G_HostileClients(TEAM_ALIENS, VEC2GLM(ent->r.currentOrigin), LOCKBLOB_RANGE);
+	int count = static_cast<int>(candidates.size());
 
-	// iterate through entities
+	if (!count)
+	{
+		return nullptr;
+	}
+
+	// iterate through them
 	// FIXME: extremely biased!
-	start = BG_randrange( MAX_CLIENTS );
+	int start = BG_randrange( count );
 
-	for (i = start; i < MAX_CLIENTS + start; i++)
+	for (int i = start; i < count + start; i++)
 	{
-		gentity_t* target = g_entities + (i % MAX_CLIENTS);
+		gentity_t* target = candidates[i % count]->oldEnt;
 
 		//if target is not valid keep searching
 		if (!target->inuse || !ATrapper_CheckTarget(ent, target))
@@ -3,6 +3,7 @@
 #include <glm/gtx/norm.hpp>
 #include <glm/gtx/io.hpp>
 #include "../Entities.h"
+#include "../sg_hostiles.h"
 
 static Log::Logger turretLogger("sgame.turrets");
 
@@ -63,13 +64,13 @@ Entity* TurretComponent::FindEntityTarget(std::function<bool(Entity&, Entity&)>
 
 	// Search best target.
 	// TODO: Iterate over all valid targets, do not assume they have to be clients.
-	ForEntities<ClientComponent>([&](Entity& candidate, ClientComponent&) {
-		if (TargetValid(candidate, true)) {
-			if (!target || CompareTargets(candidate, *target->entity)) {
-				target = candidate.oldEnt;
+	for (Entity* candidate : G_HostileClients(G_Team(entity.oldEnt), VEC2GLM(entity.oldEnt->s.origin), range)) {
+		if (TargetValid(*candidate, true)) {
+			if (!target || CompareTargets(*candidate, *target->entity)) {
+				target = candidate->oldEnt;
 			}
 		}
-	});
+	}
 
 	if (target) {
 		// TODO: Increase tracked-by counter for a new target.
@@ -210,7 +211,7 @@ bool TurretComponent::TargetValid(Entity& target, bool newTarget) {
 	}
 
 	// New targets require a line of sight.
-	if (G_LineOfFire(entity.oldEnt, target.oldEnt)) {
+	if (G_CachedLineOfFire(entity.oldEnt, target.oldEnt)) {
 		lastLineOfSightToTarget = level.time;
 	} else if (newTarget) {
 		return false;
@@ -0,0 +1,460 @@
+/*
+===========================================================================
+
+Unvanquished GPL Source Code
+Copyright (C) 2026 Unvanquished Developers
+
+This file is part of the Unvanquished GPL Source Code (Unvanquished Source Code).
+
+Unvanquished Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Unvanquished Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Unvanquished Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Unvanquished Source Code is also subject to certain additional terms.
+You should have received a copy of these additional terms immediately following the
+terms and conditions of the GNU General Public License which accompanied the Unvanquished
+Source Code.  If not, please request a copy in writing from id Software at the address
+below.
+
+If you have questions concerning this license or the applicable additional terms, you
+may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville,
+Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "sgame/lua/EntityQuery.h"
+
+#include "shared/lua/Utils.h"
+#include "sgame/sg_local.h"
+#include "sgame/Entities.h"
+#include "sgame/CBSE.h"
+
+/*
+ * Entities.query( [filter] )
+ *
+ * Finds entities in C++ and returns them packed into flat arrays, so that scripts
+ * don't have to cross into C++ once per entity and field. All filter keys are
+ * optional:
+ *
+ *   kind    "buildable", "client" or "missile"
+ *   team    "aliens", "humans" or "none"
+ *   alive   true for living entities, false for dead ones
+ *   origin  {x, y, z}, with radius: entities whose bounds are within radius
+ *   radius  see origin
+ *   mins    {x, y, z}, with maxs: entities whose bounds touch this box
+ *   maxs    see mins
+ *   fields  list of fields to return, see queryFields and queryVectorFields
+ *
+ * The result is a table with count and num (the entity numbers, ascending), and one
+ * array per requested field, in the same order as num. The vector fields origin,
+ * absmin and absmax are packed as x1, y1, z1, x2, y2, z2, …
+ */
+
+namespace Lua {
+
+namespace {
+
+enum class queryKind_t
+{
+	ANY,
+	BUILDABLE,
+	CLIENT,
+	MISSILE,
+};
+
+struct entityQuery_t
+{
+	queryKind_t kind = queryKind_t::ANY;
+	bool hasTeam = false;
+	team_t team = TEAM_NONE;
+	bool hasAlive = false;
+	bool alive = false;
+	bool hasSphere = false;
+	vec3_t origin;
+	float radius = 0.0f;
+	bool hasBox = false;
+	vec3_t mins, maxs;
+	std::vector<int> fields;
+};
+
+const char *TeamString( team_t team )
+{
+	switch ( team )
+	{
+		case TEAM_ALIENS: return "aliens";
+		case TEAM_HUMANS: return "humans";
+		default:          return "none";
+	}
+}
+
+void PushHealth( lua_State* L, gentity_t *ent )
+{
+	HealthComponent *health = ent->entity->Get<HealthComponent>();
+	lua_pushnumber( L, health ? health->Health() : 0.0f );
+}
+
+void PushTeam( lua_State* L, gentity_t *ent )
+{
+	lua_pushstring( L, TeamString( G_Team( ent ) ) );
+}
+
+void PushClassname( lua_State* L, gentity_t *ent )
+{
+	lua_pushstring( L, ent->classname ? ent->classname : "" );
+}
+
+void PushBuildable( lua_State* L, gentity_t *ent )
+{
+	lua_pushstring( L, ent->s.eType == entityType_t::ET_BUILDABLE ? BG_Buildable( ent->s.modelindex )->name : "" );
+}
+
+void PushClass( lua_State* L, gentity_t *ent )
+{
+	lua_pushstring( L, ent->client ? BG_Class( ent->client->ps.stats[ STAT_CLASS ] )->name : "" );
+}
+
+void PushAlive( lua_State* L, gentity_t *ent )
+{
+	lua_pushboolean( L, Entities::IsAlive( ent ) );
+}
+
+void PushPowered( lua_State* L, gentity_t *ent )
+{
+	lua_pushboolean( L, ent->powered );
+}
+
+void PushSpawned( lua_State* L, gentity_t *ent )
+{
+	lua_pushboolean( L, ent->spawned );
+}
+
+struct queryField_t
+{
+	const char *name;
+	void ( *push )( lua_State* L, gentity_t *ent );
+};
+
+// vector fields are handled separately as they take three slots per entity
+struct queryVectorField_t
+{
+	const char *name;
+	const float *( *get )( const gentity_t *ent );
+};
+
+const queryVectorField_t queryVectorFields[] =
+{
+	{ "origin", []( const gentity_t *ent ) -> const float * { return ent->r.currentOrigin; } },
+	{ "absmin", []( const gentity_t *ent ) -> const float * { return ent->r.absmin; } },
+	{ "absmax", []( const gentity_t *ent ) -> const float * { return ent->r.absmax; } },
+};
+
+const queryField_t queryFields[] =
+{
+	{ "alive",     PushAlive     },
+	{ "buildable", PushBuildable },
+	{ "class",     PushClass     },
+	{ "classname", PushClassname },
+	{ "health",    PushHealth    },
+	{ "powered",   PushPowered   },
+	{ "spawned",   PushSpawned   },
+	{ "team",      PushTeam      },
+};
+
+// vector fields are stored as -1 - their index in queryVectorFields in entityQuery_t::fields
+int VectorFieldIndex( int field )
+{
+	return -1 - field;
+}
+
+bool GetVec3Field( lua_State* L, int table, const char *key, vec3_t out )
+{
+	lua_getfield( L, table, key );
+	bool found = !lua_isnil( L, -1 );
+
+	if ( found && !Shared::Lua::CheckVec3( L, lua_gettop( L ), out ) )
+	{
+		luaL_error( L, "Entities.query: %s must be a table of three numbers", key );
+	}
+
+	lua_pop( L, 1 );
+	return found;
+}
+
+void ParseQuery( lua_State* L, int table, entityQuery_t &query )
+{
+	if ( lua_isnoneornil( L, table ) )
+	{
+		return;
+	}
+
+	luaL_checktype( L, table, LUA_TTABLE );
+
+	lua_getfield( L, table, "kind" );
+	if ( !lua_isnil( L, -1 ) )
+	{
+		const char *kind = luaL_checkstring( L, -1 );
+
+		if ( !Q_stricmp( kind, "buildable" ) )
+			query.kind = queryKind_t::BUILDABLE;
+		else if ( !Q_stricmp( kind, "client" ) )
+			query.kind = queryKind_t::CLIENT;
+		else if ( !Q_stricmp( kind, "missile" ) )
+			query.kind = queryKind_t::MISSILE;
+		else
+			luaL_error( L, "Entities.query: unknown kind '%s'", kind );
+	}
+	lua_pop( L, 1 );
+
+	lua_getfield( L, table, "team" );
+	if ( !lua_isnil( L, -1 ) )
+	{
+		const char *team = luaL_checkstring( L, -1 );
+		query.hasTeam = true;
+
+		if ( !Q_stricmp( team, "none" ) )
+			query.team = TEAM_NONE;
+		else if ( ( query.team = BG_PlayableTeamFromString( team ) ) == TEAM_NONE )
+			luaL_error( L, "Entities.query: unknown team '%s'", team );
+	}
+	lua_pop( L, 1 );
+
+	lua_getfield( L, table, "alive" );
+	if ( !lua_isnil( L, -1 ) )
+	{
+		query.hasAlive = true;
+		query.alive = lua_toboolean( L, -1 );
+	}
+	lua_pop( L, 1 );
+
+	if ( GetVec3Field( L, table, "origin", query.origin ) )
+	{
+		lua_getfield( L, table, "radius" );
+		query.radius = luaL_checknumber( L, -1 );
+		lua_pop( L, 1 );
+		query.hasSphere = true;
+	}
+
+	if ( GetVec3Field( L, table, "mins", query.mins ) )
+	{
+		if ( !GetVec3Field( L, table, "maxs", query.maxs ) )
+		{
+			luaL_error( L, "Entities.query: mins requires maxs" );
+		}
+		query.hasBox = true;
+	}
+
+	lua_getfield( L, table, "fields" );
+	if ( !lua_isnil( L, -1 ) )
+	{
+		luaL_checktype( L, -1, LUA_TTABLE );
+
+		for ( int i = 1; ; i++ )
+		{
+			lua_rawgeti( L, -1, i );
+			if ( lua_isnil( L, -1 ) )
+			{
+				lua_pop( L, 1 );
+				break;
+			}
+
+			const char *name = luaL_checkstring( L, -1 );
+			int index = 0;
+
+			for ( int vectorIndex = 0; vectorIndex < static_cast<int>( ARRAY_LEN( queryVectorFields ) ); vectorIndex++ )
+			{
+				if ( !Q_stricmp( name, queryVectorFields[ vectorIndex ].name ) )
+					index = VectorFieldIndex( vectorIndex );
+			}
+
+			if ( index >= 0 )
+			{
+				for ( index = 0; index < static_cast<int>( ARRAY_LEN( queryFields ) ); index++ )
+				{
+					if ( !Q_stricmp( name, queryFields[ index ].name ) )
+						break;
+				}
+
+				if ( index == static_cast<int>( ARRAY_LEN( queryFields ) ) )
+				{
+					luaL_error( L, "Entities.query: unknown field '%s'", name );
+				}
+			}
+
+			query.fields.push_back( index );
+			lua_pop( L, 1 );
+		}
+	}
+	lua_pop( L, 1 );
+}
+
+bool MatchesQuery( gentity_t *ent, const entityQuery_t &query )
+{
+	if ( !ent->inuse || !ent->entity )
+		return false;
+
+	switch ( query.kind )
+	{
+		case queryKind_t::BUILDABLE:
+			if ( !ent->entity->Get<BuildableComponent>() )
+				return false;
+			break;
+
+		case queryKind_t::CLIENT:
+			if ( !ent->entity->Get<ClientComponent>() )
+				return false;
+			break;
+
+		case queryKind_t::MISSILE:
+			if ( !ent->entity->Get<MissileComponent>() )
+				return false;
+			break;
+
+		default:
+			break;
+	}
+
+	if ( query.hasTeam && G_Team( ent ) != query.team )
+		return false;
+
+	if ( query.hasAlive && ( query.alive ? !Entities::IsAlive( ent ) : !Entities::IsDead( ent ) ) )
+		return false;
+
+	if ( query.hasSphere && G_DistanceToBBox( VEC2GLM( query.origin ), ent ) > query.radius )
+		return false;
+
+	return true;
+}
+
+// Collects the matching entities, using the world sectors when the query is bounded.
+std::vector<int> RunQuery( const entityQuery_t &query )
+{
+	std::vector<int> result;
+
+	if ( query.hasSphere || query.hasBox )
+	{
+		vec3_t mins, maxs;
+		int    list[ MAX_GENTITIES ];
+
+		if ( query.hasSphere )
+		{
+			for ( int i = 0; i < 3; i++ )
+			{
+				mins[ i ] = query.origin[ i ] - query.radius;
+				maxs[ i ] = query.origin[ i ] + query.radius;
+			}
+
+			if ( query.hasBox )
+			{
+				for ( int i = 0; i < 3; i++ )
+				{
+					mins[ i ] = std::max( mins[ i ], query.mins[ i ] );
+					maxs[ i ] = std::min( maxs[ i ], query.maxs[ i ] );
+				}
+			}
+		}
+		else
+		{
+			VectorCopy( query.mins, mins );
+			VectorCopy( query.maxs, maxs );
+		}
+
+		int num = trap_EntitiesInBox( mins, maxs, list, MAX_GENTITIES );
+
+		for ( int i = 0; i < num; i++ )
+		{
+			if ( MatchesQuery( &g_entities[ list[ i ] ], query ) )
+			{
+				result.push_back( list[ i ] );
+			}
+		}
+
+		std::sort( result.begin(), result.end() );
+		return result;
+	}
+
+	for ( int i = 0; i < level.num_entities; i++ )
+	{
+		if ( MatchesQuery( &g_entities[ i ], query ) )
+		{
+			result.push_back( i );
+		}
+	}
+
+	return result;
+}
+
+int Entities_query( lua_State* L )
+{
+	entityQuery_t query;
+	ParseQuery( L, 1, query );
+
+	std::vector<int> matches = RunQuery( query );
+	int count = static_cast<int>( matches.size() );
+
+	lua_createtable( L, 0, 2 + query.fields.size() );
+
+	lua_pushinteger( L, count );
+	lua_setfield( L, -2, "count" );
+
+	lua_createtable( L, count, 0 );
+	for ( int i = 0; i < count; i++ )
+	{
+		lua_pushinteger( L, matches[ i ] );
+		lua_rawseti( L, -2, i + 1 );
+	}
+	lua_setfield( L, -2, "num" );
+
+	for ( int field : query.fields )
+	{
+		if ( field < 0 )
+		{
+			const queryVectorField_t &vectorField = queryVectorFields[ VectorFieldIndex( field ) ];
+
+			lua_createtable( L, 3 * count, 0 );
+			for ( int i = 0; i < count; i++ )
+			{
+				const float *value = vectorField.get( &g_entities[ matches[ i ] ] );
+
+				for ( int j = 0; j < 3; j++ )
+				{
+					lua_pushnumber( L, value[ j ] );
+					lua_rawseti( L, -2, 3 * i + j + 1 );
+				}
+			}
+			lua_setfield( L, -2, vectorField.name );
+			continue;
+		}
+
+		lua_createtable( L, count, 0 );
+		for ( int i = 0; i < count; i++ )
+		{
+			queryFields[ field ].push( L, &g_entities[ matches[ i ] ] );
+			lua_rawseti( L, -2, i + 1 );
+		}
+		lua_setfield( L, -2, queryFields[ field ].name );
+	}
+
+	return 1;
+}
+
+} // namespace
+
+void RegisterEntityQueries( lua_State* L )
+{
+	lua_newtable( L );
+	lua_pushcfunction( L, Entities_query );
+	lua_setfield( L, -2, "query" );
+	lua_setglobal( L, "Entities" );
+}
+
+} // namespace Lua
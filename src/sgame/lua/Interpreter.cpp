@@ -33,6 +33,7 @@ Maryland 20850 USA.
 */
 
 #include "sgame/lua/Interpreter.h"
+#include "sgame/lua/EntityQuery.h"
 
 #include "common/Command.h"
 #include "common/FileSystem.h"
@@ -40,6 +41,7 @@ Maryland 20850 USA.
 #include "shared/bg_public.h"
 #include "shared/lua/LuaLib.h"
 #include "shared/lua/Utils.h"
+#include "shared/lua/register_lua_extensions.h"
 #include "sgame/sg_local.h"
 
 using Shared::Lua::LuaLib;
@@ -183,6 +185,15 @@ void Initialize()
 	luaL_openlibs( L );
 	OverrideGlobalLuaFunctions();
 	BG_InitializeLuaConstants( L );
+	RegisterEntityQueries( L );
+}
+
+void UpdateTimers( int time )
+{
+	if ( L )
+	{
+		Shared::Lua::UpdateTimers( time );
+	}
 }
 
 void Shutdown()
@@ -237,4 +248,23 @@ class LuaCommand : Cmd::StaticCmd
 
 static LuaCommand luaCommand;
 
+class LuaTimersCommand : Cmd::StaticCmd
+{
+   public:
+	LuaTimersCommand() : Cmd::StaticCmd( "luaTimers", Cmd::SGAME_VM, "print CPU time spent in Lua timer callbacks" ) {}
+
+	void Run( const Cmd::Args& ) const
+	{
+		Print( "%8s %8s %10s %8s  %s", "calls", "aborted", "total ms", "max ms", "script" );
+
+		for ( const Shared::Lua::TimerStats& stats : Shared::Lua::GetTimerStats() )
+		{
+			Print( "%8d %8d %10.1f %8.1f  %s", stats.calls, stats.aborted, stats.totalUs / 1000.0,
+			       stats.maxUs / 1000.0, stats.script );
+		}
+	}
+};
+
+static LuaTimersCommand luaTimersCommand;
+
 }  // namespace Lua
@@ -44,6 +44,9 @@ void Initialize();
 
 void Shutdown();
 
+// Runs the Timer.add callbacks that are due.
+void UpdateTimers(int time);
+
 lua_State* State();
 
 bool ExecScript(Str::StringRef scriptPath);
@@ -29,6 +29,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Entities.h"
 #include "CBSE.h"
 #include "sg_cm_world.h"
+#include "sg_service.h"
 
 bool ClientInactivityTimer( gentity_t *ent, bool active );
 
@@ -479,7 +480,7 @@ void  G_TouchTriggers( gentity_t *ent )
 	VectorSubtract( mins, range, mins );
 	VectorAdd( maxs, range, maxs );
 
-	num = trap_EntitiesInBox( mins, maxs, touch, MAX_GENTITIES );
+	num = G_TriggersInBox( mins, maxs, touch, MAX_GENTITIES );
 
 	// can't use ent->absmin, because that has a one unit pad
 	VectorAdd( ent->client->ps.origin, ent->r.mins, mins );
@@ -952,20 +953,11 @@ static void ClientTimerActions( gentity_t *ent, int msec )
 				// Set validity bit on buildable
 				if ( buildable > BA_NONE )
 				{
-					vec3_t forward, aimDir, normal;
 					vec3_t dummy, dummy2;
 					int dummy3;
-					int dist;
-
-					BG_GetClientNormal( &client->ps,normal );
-					AngleVectors( client->ps.viewangles, aimDir, nullptr, nullptr );
-					ProjectPointOnPlane( forward, aimDir, normal );
-					VectorNormalize( forward );
-
-					dist = BG_Class( ent->client->ps.stats[ STAT_CLASS ] )->buildDist * DotProduct( forward, aimDir );
 
 					client->ps.stats[ STAT_BUILDABLE ] &= ~SB_BUILDABLE_STATE_MASK;
-					client->ps.stats[ STAT_BUILDABLE ] |= SB_BUILDABLE_FROM_IBE( G_CanBuild( ent, buildable, dist, dummy, dummy2, &dummy3 ) );
+					client->ps.stats[ STAT_BUILDABLE ] |= SB_BUILDABLE_FROM_IBE( G_CanBuildPreview( ent, buildable, dummy, dummy2, &dummy3 ) );
 
 					if ( buildable == BA_H_DRILL || buildable == BA_A_LEECH )
 					{
@@ -1658,7 +1650,6 @@ static int FindAlienHealthSource( gentity_t *self )
 	int       ret = 0, closeTeammates = 0;
 	float     distance, minBoosterDistance = FLT_MAX;
 	bool      needsHealing;
-	gentity_t *ent;
 
 	if ( !self || !self->client )
 	{
@@ -1669,20 +1660,33 @@ static int FindAlienHealthSource( gentity_t *self )
 
 	self->boosterUsed = nullptr;
 
-	for ( ent = nullptr; ( ent = G_IterateEntities( ent, nullptr, true, 0, nullptr ) ); )
+	for ( int i = 0; i < level.maxclients; i++ )
 	{
-		if ( !G_OnSameTeam( self, ent ) ) continue;
-		if ( Entities::IsDead( ent ) )              continue;
+		gentity_t *ent = &g_entities[ i ];
+
+		if ( !ent->inuse || !ent->enabled || ent == self ) continue;
+		if ( !G_OnSameTeam( self, ent ) )                   continue;
+		if ( Entities::IsDead( ent ) )                      continue;
 
 		distance = Distance( ent->s.origin, self->s.origin );
 
-		if ( ent->client && self != ent && distance < REGEN_TEAMMATE_RANGE &&
-		     G_LineOfSight( self, ent, MASK_SOLID, false ) )
+		if ( distance < REGEN_TEAMMATE_RANGE && G_LineOfSight( self, ent, MASK_SOLID, false ) )
 		{
 			closeTeammates++;
 			ret |= ( closeTeammates > 1 ) ? SS_HEALING_4X : SS_HEALING_2X;
 		}
-		else if ( ent->s.eType == entityType_t::ET_BUILDABLE && ent->spawned && ent->powered )
+	}
+
+	// the buildables around are assigned once per frame
+	for ( gentity_t *ent : G_ServiceProviders( self ) )
+	{
+		if ( !ent->inuse || !ent->enabled )  continue;
+		if ( !G_OnSameTeam( self, ent ) )     continue;
+		if ( Entities::IsDead( ent ) )        continue;
+
+		distance = Distance( ent->s.origin, self->s.origin );
+
+		if ( ent->s.eType == entityType_t::ET_BUILDABLE && ent->spawned && ent->powered )
 		{
 			if ( ent->s.modelindex == BA_A_BOOSTER && ent->powered &&
 			     distance < REGEN_BOOSTER_RANGE )
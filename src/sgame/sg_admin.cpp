@@ -42,6 +42,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "sg_local.h"
 
 #include <glm/gtx/norm.hpp>
+#include <chrono>
+#include <random>
 
 #include "CBSE.h"
 #include "Entities.h"
@@ -82,6 +84,8 @@ struct g_admin_ban_t
 	int                expires;
 	char               banner[ MAX_NAME_LENGTH ];
 	int                warnCount;
+
+	int                position; // in g_admin_bans, maintained by the ban index
 };
 
 struct g_admin_command_t
@@ -516,6 +520,118 @@ g_admin_spec_t    *g_admin_specs = nullptr;
 g_admin_command_t *g_admin_commands = nullptr;
 std::vector<g_admin_vote_t> g_admin_votes;
 
+/*
+ * Lookup indexes for admins, bans and spec locks, so that connecting players
+ * don't have to be compared against every entry. They are rebuilt on the next
+ * lookup after any change to the lists, see admin_invalidate_indexes.
+ */
+namespace {
+struct banTrieNode_t
+{
+	int              children[ 2 ] = { -1, -1 };
+	std::vector<int> bans; // positions of the bans whose netmask ends here
+};
+
+bool adminIndexesDirty = true;
+
+std::unordered_map<std::string, g_admin_admin_t *, Str::IHash, Str::IEqual> adminsByGuid;
+std::unordered_map<std::string, g_admin_spec_t *, Str::IHash, Str::IEqual> specsByGuid;
+
+std::vector<g_admin_ban_t *> bansByPosition;
+std::unordered_map<std::string, std::vector<int>, Str::IHash, Str::IEqual> bansByGuid;
+std::vector<banTrieNode_t> banTries[ 2 ]; // prefix tries of banned addresses, for IPv4 and IPv6
+}
+
+static void admin_invalidate_indexes()
+{
+	adminIndexesDirty = true;
+}
+
+/*
+ * The number of significant bits in an address, the same way G_AddressCompare
+ * interprets it.
+ */
+static int admin_address_bits( const addr_t *addr )
+{
+	int max = addr->type == IPv6 ? 128 : 32;
+
+	return ( addr->mask < 1 || addr->mask > max ) ? max : addr->mask;
+}
+
+static int admin_address_bit( const addr_t *addr, int bit )
+{
+	return ( addr->addr[ bit / 8 ] >> ( 7 - bit % 8 ) ) & 1;
+}
+
+static void admin_index_ban_address( g_admin_ban_t *ban )
+{
+	if ( ban->ip.type != IPv4 && ban->ip.type != IPv6 )
+	{
+		return;
+	}
+
+	std::vector<banTrieNode_t> &trie = banTries[ ban->ip.type ];
+	int bits = admin_address_bits( &ban->ip );
+	int node = 0;
+
+	for ( int i = 0; i < bits; i++ )
+	{
+		int bit = admin_address_bit( &ban->ip, i );
+
+		if ( trie[ node ].children[ bit ] < 0 )
+		{
+			trie[ node ].children[ bit ] = static_cast<int>( trie.size() );
+			trie.emplace_back();
+		}
+
+		node = trie[ node ].children[ bit ];
+	}
+
+	trie[ node ].bans.push_back( ban->position );
+}
+
+static void admin_update_indexes()
+{
+	if ( !adminIndexesDirty )
+	{
+		return;
+	}
+
+	adminIndexesDirty = false;
+
+	adminsByGuid.clear();
+
+	for ( g_admin_admin_t *admin = g_admin_admins; admin; admin = admin->next )
+	{
+		// the first entry wins, like in a linear search
+		adminsByGuid.emplace( admin->guid, admin );
+	}
+
+	specsByGuid.clear();
+
+	for ( g_admin_spec_t *spec = g_admin_specs; spec; spec = spec->next )
+	{
+		specsByGuid.emplace( spec->guid, spec );
+	}
+
+	bansByPosition.clear();
+	bansByGuid.clear();
+
+	for ( std::vector<banTrieNode_t> &trie : banTries )
+	{
+		trie.clear();
+		trie.emplace_back();
+	}
+
+	for ( g_admin_ban_t *ban = g_admin_bans; ban; ban = ban->next )
+	{
+		ban->position = static_cast<int>( bansByPosition.size() );
+		bansByPosition.push_back( ban );
+		bansByGuid[ ban->guid ].push_back( ban->position );
+		admin_index_ban_address( ban );
+	}
+}
+
 /* ent must be non-nullptr */
 #define G_ADMIN_NAME( ent ) ( ent->client->pers.admin ? ent->client->pers.admin->name : ent->client->pers.netname )
 
@@ -775,17 +891,11 @@ static g_admin_level_t *G_admin_level( const int l )
 
 g_admin_admin_t *G_admin_admin( const char *guid )
 {
-	g_admin_admin_t *admin;
+	admin_update_indexes();
 
-	for ( admin = g_admin_admins; admin; admin = admin->next )
-	{
-		if ( !Q_stricmp( admin->guid, guid ) )
-		{
-			return admin;
-		}
-	}
+	auto it = adminsByGuid.find( guid );
 
-	return nullptr;
+	return it != adminsByGuid.end() ? it->second : nullptr;
 }
 
 static g_admin_command_t *G_admin_command( const char *cmd )
@@ -1743,8 +1853,8 @@ static bool G_admin_ban_matches( g_admin_ban_t *ban, gentity_t *ent )
 
 static g_admin_ban_t *G_admin_match_ban( gentity_t *ent, const g_admin_ban_t *start )
 {
-	int           t;
-	g_admin_ban_t *ban;
+	int              t;
+	std::vector<int> matches;
 
 	t = Com_GMTime( nullptr );
 
@@ -1753,23 +1863,181 @@ static g_admin_ban_t *G_admin_match_ban( gentity_t *ent, const g_admin_ban_t *st
 		return nullptr;
 	}
 
-	for ( ban = start ? start->next : g_admin_bans; ban; ban = ban->next )
+	admin_update_indexes();
+
+	// bans on the guid
+	auto it = bansByGuid.find( ent->client->pers.guid );
+
+	if ( it != bansByGuid.end() )
+	{
+		matches = it->second;
+	}
+
+	// bans on any prefix of the address
+	const addr_t *ip = &ent->client->pers.ip;
+
+	if ( !G_admin_permission( ent, ADMF_IMMUNITY ) && ( ip->type == IPv4 || ip->type == IPv6 ) )
 	{
-		// 0 is for perm ban
-		if ( ban->expires != 0 && ban->expires <= t )
+		const std::vector<banTrieNode_t> &trie = banTries[ ip->type ];
+		int bits = ip->type == IPv6 ? 128 : 32;
+		int node = 0;
+
+		for ( int i = 0; i < bits && node >= 0; i++ )
+		{
+			node = trie[ node ].children[ admin_address_bit( ip, i ) ];
+
+			if ( node >= 0 )
+			{
+				matches.insert( matches.end(), trie[ node ].bans.begin(), trie[ node ].bans.end() );
+			}
+		}
+	}
+
+	// keep the order of the ban list
+	std::sort( matches.begin(), matches.end() );
+	matches.erase( std::unique( matches.begin(), matches.end() ), matches.end() );
+
+	for ( int position : matches )
+	{
+		if ( start && position <= start->position )
 		{
 			continue;
 		}
 
-		if ( G_admin_ban_matches( ban, ent ) )
+		g_admin_ban_t *ban = bansByPosition[ position ];
+
+		// 0 is for perm ban
+		if ( ban->expires != 0 && ban->expires <= t )
 		{
-			return ban;
+			continue;
 		}
+
+		return ban;
 	}
 
 	return nullptr;
 }
 
+class BanBenchCmd : public Cmd::StaticCmd
+{
+public:
+	BanBenchCmd() : StaticCmd( "banBench", Cmd::SGAME_VM, "time connect ban lookups against a generated ban list, with and without the ban index" ) {}
+	void Run( const Cmd::Args& args ) const override
+	{
+		int banCount = 50000, connects = 1000;
+
+		if ( ( args.Argc() > 1 && ( !Str::ParseInt( banCount, args.Argv( 1 ) ) || banCount <= 0 ) ) ||
+		     ( args.Argc() > 2 && ( !Str::ParseInt( connects, args.Argv( 2 ) ) || connects <= 0 ) ) )
+		{
+			PrintUsage( args, "[bans] [connects]" );
+			return;
+		}
+
+		std::mt19937 rng( 0 );
+		static const int masks[] = { 16, 24, 32, 32 };
+
+		auto randomGuid = [ & ]( char *guid ) {
+			Q_strncpyz( guid, Str::Format( "%08X%08X%08X%08X", rng(), rng(), rng(), rng() ).c_str(), 33 );
+		};
+		auto randomAddress = [ & ]( int mask ) {
+			return Str::Format( "%d.%d.%d.%d/%d", rng() & 0xff, rng() & 0xff, rng() & 0xff, rng() & 0xff, mask );
+		};
+
+		// generated bans replace the real ones while benchmarking
+		std::vector<g_admin_ban_t> bans( banCount );
+
+		for ( int i = 0; i < banCount; i++ )
+		{
+			randomGuid( bans[ i ].guid );
+			G_AddressParse( randomAddress( masks[ rng() % ARRAY_LEN( masks ) ] ).c_str(), &bans[ i ].ip );
+			bans[ i ].next = i + 1 < banCount ? &bans[ i + 1 ] : nullptr;
+		}
+
+		// connecting players, some of them banned by guid or by address
+		static gclient_t client;
+		static gentity_t ent;
+		std::vector<clientPersistant_t> players( connects );
+
+		for ( int i = 0; i < connects; i++ )
+		{
+			const g_admin_ban_t &ban = bans[ rng() % banCount ];
+
+			randomGuid( players[ i ].guid );
+			G_AddressParse( randomAddress( 32 ).c_str(), &players[ i ].ip );
+
+			if ( i % 10 == 0 )
+			{
+				Q_strncpyz( players[ i ].guid, ban.guid, sizeof( players[ i ].guid ) );
+			}
+			else if ( i % 10 == 1 )
+			{
+				const byte *b = ban.ip.addr;
+				G_AddressParse( Str::Format( "%d.%d.%d.%d", b[ 0 ], b[ 1 ], b[ 2 ], b[ 3 ] ).c_str(), &players[ i ].ip );
+			}
+		}
+
+		g_admin_ban_t *realBans = g_admin_bans;
+		g_admin_bans = &bans[ 0 ];
+		ent.client = &client;
+
+		auto start = std::chrono::steady_clock::now();
+
+		admin_invalidate_indexes();
+		admin_update_indexes();
+
+		auto built = std::chrono::steady_clock::now();
+
+		std::vector<g_admin_ban_t *> linear( connects ), indexed( connects );
+		int t = Com_GMTime( nullptr );
+
+		for ( int i = 0; i < connects; i++ )
+		{
+			client.pers = players[ i ];
+			linear[ i ] = nullptr;
+
+			for ( g_admin_ban_t *ban = g_admin_bans; ban; ban = ban->next )
+			{
+				if ( ( ban->expires == 0 || ban->expires > t ) && G_admin_ban_matches( ban, &ent ) )
+				{
+					linear[ i ] = ban;
+					break;
+				}
+			}
+		}
+
+		auto middle = std::chrono::steady_clock::now();
+
+		for ( int i = 0; i < connects; i++ )
+		{
+			client.pers = players[ i ];
+			indexed[ i ] = G_admin_match_ban( &ent, nullptr );
+		}
+
+		auto end = std::chrono::steady_clock::now();
+
+		g_admin_bans = realBans;
+		admin_invalidate_indexes();
+		client.pers = {};
+
+		int banned = 0, mismatches = 0;
+
+		for ( int i = 0; i < connects; i++ )
+		{
+			banned += linear[ i ] != nullptr;
+			mismatches += linear[ i ] != indexed[ i ];
+		}
+
+		std::chrono::duration<double, std::milli> buildTime = built - start, linearTime = middle - built, indexedTime = end - middle;
+
+		Print( "bans:       %d, %d connects, %d banned", banCount, connects, banned );
+		Print( "index:      built in %.3f ms", buildTime.count() );
+		Print( "ban list:   %.3f ms, %.2f µs per connect", linearTime.count(), linearTime.count() * 1000.0 / connects );
+		Print( "ban index:  %.3f ms, %.2f µs per connect", indexedTime.count(), indexedTime.count() * 1000.0 / connects );
+		Print( "mismatches: %d", mismatches );
+	}
+};
+static BanBenchCmd banBenchCmdRegistration;
+
 bool G_admin_ban_check( gentity_t *ent, char *reason, int rlen )
 {
 	g_admin_ban_t *ban = nullptr;
@@ -1822,15 +2090,12 @@ g_admin_spec_t *G_admin_match_spec( gentity_t *ent )
 		return nullptr;
 	}
 
-	for ( spec = g_admin_specs; spec; spec = spec->next )
-	{
-		if ( !Q_stricmp( spec->guid, ent->client->pers.guid ) )
-		{
-			return spec;
-		}
-	}
+	admin_update_indexes();
 
-	return nullptr;
+	auto it = specsByGuid.find( ent->client->pers.guid );
+	spec = it != specsByGuid.end() ? it->second : nullptr;
+
+	return spec;
 }
 
 bool G_admin_cmd_check( gentity_t *ent )
@@ -2413,6 +2678,8 @@ bool G_admin_readconfig( gentity_t *ent )
 		llsort( ( struct llist ** ) &g_admin_admins, cmplevel );
 	}
 
+	admin_invalidate_indexes();
+
 	// restore admin mapping
 	for ( i = 0; i < level.maxclients; i++ )
 	{
@@ -2596,6 +2863,7 @@ bool G_admin_setlevel( gentity_t *ent )
 		vic->client->pers.admin = a;
 		Q_strncpyz( a->guid, vic->client->pers.guid, sizeof( a->guid ) );
 		Com_GMTime( &a->lastSeen ); // player is connected...
+		admin_invalidate_indexes();
 	}
 
 	if ( !a )
@@ -2845,6 +3113,8 @@ static g_admin_ban_t *admin_create_ban_entry( gentity_t *ent, char *netname, cha
 		b->expires = t + seconds;
 	}
 
+	admin_invalidate_indexes();
+
 	return b;
 }
 
@@ -3277,6 +3547,7 @@ bool G_admin_unban( gentity_t *ent )
 		}
 
 		BG_Free( ban );
+		admin_invalidate_indexes();
 	}
 
 	if ( wasWarning )
@@ -3426,6 +3697,7 @@ bool G_admin_adjustban( gentity_t *ent )
 		}
 
 		ban->ip.mask = mask;
+		admin_invalidate_indexes();
 	}
 
 	reason = ConcatArgs( 3 + skiparg );
@@ -3578,6 +3850,7 @@ bool G_admin_speclock( gentity_t *ent )
 	}
 
 	Q_strncpyz( spec->guid, vic->client->pers.guid, sizeof( spec->guid ) );
+	admin_invalidate_indexes();
 
 	lockTime = std::min( 86400, lockTime );
 	if ( lockTime )
@@ -6101,6 +6374,8 @@ void G_admin_cleanup()
 
 	g_admin_specs = nullptr;
 
+	admin_invalidate_indexes();
+
 	for ( c = g_admin_commands; c; c = (g_admin_command_t*) n )
 	{
 		n = c->next;
@@ -33,6 +33,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Entities.h"
 #include "CBSE.h"
 #include "sg_cm_world.h"
+#include "sg_events.h"
+#include "sg_service.h"
 
 /**
  * @return Whether the means of death allow for an under-attack warning.
@@ -292,15 +294,17 @@ static void ABarricade_Touch( gentity_t *self, gentity_t *other )
 
 static void ABooster_Think( gentity_t *self )
 {
-	gentity_t *ent;
 	bool  playHealingEffect = false;
 
 	self->nextthink = level.time + BOOST_REPEAT_ANIM / 4;
 
 	// check if there is a closeby alien that used this booster for healing recently
-	for ( ent = nullptr; ( ent = G_IterateEntitiesWithinRadius( ent, VEC2GLM( self->s.origin ), REGEN_BOOSTER_RANGE ) ); )
+	for ( gentity_t *ent : G_ServiceOccupants( self ) )
 	{
-		if ( ent->boosterUsed == self && ent->boosterTime == level.previousTime )
+		glm::vec3 center = VEC2GLM( ent->r.currentOrigin ) + ( VEC2GLM( ent->r.mins ) + VEC2GLM( ent->r.maxs ) ) * 0.5f;
+
+		if ( ent->inuse && ent->boosterUsed == self && ent->boosterTime == level.previousTime &&
+		     glm::distance( VEC2GLM( self->s.origin ), center ) <= REGEN_BOOSTER_RANGE )
 		{
 			playHealingEffect = true;
 			break;
@@ -369,30 +373,63 @@ static void HArmoury_Use( gentity_t *self, gentity_t*, gentity_t *activator )
 }
 
 /**
- * @brief Orders buildables that were pre-selected for power down to make good a budget deficit.
- * @todo Add const to parameters once there is a const variant of Entity::Get.
+ * @brief A buildable that can be shut down to make good a budget deficit, along with the
+ *        values it is ordered by.
  */
-static bool CompareBuildablesForPowerSaving(Entity* a, Entity* b)
+struct powerSavingCandidate_t
 {
-	if (!a) return false;
-	if (!b) return true;
-
-	const BuildableComponent* aC = a->Get<BuildableComponent>();
-	const BuildableComponent* bC = b->Get<BuildableComponent>();
+	Entity *entity;
+	bool   marked;
+	int    markTime;
+	float  distanceToBase;
+	int    buildPoints;
+};
 
+/**
+ * @brief Orders buildables that were pre-selected for power down to make good a budget deficit.
+ */
+static bool CompareBuildablesForPowerSaving(const powerSavingCandidate_t &a, const powerSavingCandidate_t &b)
+{
 	// Prefer the marked buildable.
-	if ( aC->MarkedForDeconstruction() && !bC->MarkedForDeconstruction()) return true;
-	if (!aC->MarkedForDeconstruction() &&  bC->MarkedForDeconstruction()) return false;
+	if ( a.marked && !b.marked) return true;
+	if (!a.marked &&  b.marked) return false;
 
 	// If both are marked, prefer the one marked last.
-	if (aC->MarkedForDeconstruction() && bC->MarkedForDeconstruction()) {
-		return (aC->GetMarkTime() > bC->GetMarkTime());
+	if (a.marked && b.marked) {
+		return (a.markTime > b.markTime);
 	}
 
 	// Prefer the buildable further away from the base.
 	// Note that this function is supposed to be used only when there is a base, since otherwise
 	// every structure that can shut down did so already.
-	return (G_DistanceToBase(a->oldEnt) > G_DistanceToBase(b->oldEnt));
+	return (a.distanceToBase > b.distanceToBase);
+}
+
+/**
+ * @brief The buildables of a team that can change their power state, sorted for power saving.
+ *        Only rebuilt when a buildable appears, disappears, dies, is marked or changes its
+ *        power state, or when the main buildable changes.
+ */
+struct powerStateCache_t
+{
+	int       generation = -1;
+	gentity_t *activeMainBuildable = nullptr;
+	gentity_t *mainBuildable = nullptr;
+	bool      BPVampire = false;
+	std::vector<powerSavingCandidate_t> powered;
+	std::vector<powerSavingCandidate_t> unpowered;
+	int       unpoweredBuildableTotal = 0;
+};
+
+static int powerStateGeneration = 0;
+static powerStateCache_t powerStateCache[ NUM_TEAMS ];
+
+/**
+ * @brief Makes the next G_UpdateBuildablePowerStates look at all buildables again.
+ */
+void G_InvalidateBuildablePowerStates()
+{
+	powerStateGeneration++;
 }
 
 /**
@@ -400,67 +437,96 @@ static bool CompareBuildablesForPowerSaving(Entity* a, Entity* b)
  */
 void G_UpdateBuildablePowerStates()
 {
-	gentity_t* activeMainBuildable;
-
 	for (team_t team = TEAM_NONE; (team = G_IterateTeams(team)); ) {
-		std::vector<Entity*> poweredBuildables;
-		std::vector<Entity*> unpoweredBuildables;
-		int unpoweredBuildableTotal = 0;
-		activeMainBuildable = G_ActiveMainBuildable(team);
-
-		ForEntities<BuildableComponent>([&](Entity& entity, BuildableComponent& buildableComponent) {
-			if (G_Team(entity.oldEnt) != team) return;
+		powerStateCache_t &cache = powerStateCache[team];
+		gentity_t *activeMainBuildable = G_ActiveMainBuildable(team);
+		gentity_t *mainBuildable = G_MainBuildable(team);
+
+		// Let entities waiting for a main buildable know.
+		if ((cache.activeMainBuildable != nullptr) != (activeMainBuildable != nullptr)) {
+			gameEventData_t data = {};
+			data.team = team;
+			data.active = activeMainBuildable != nullptr;
+			G_PublishGameEvent(gameEvent_t::MAIN_BUILDABLE_STATE, data);
+		}
+
+		if (cache.generation != powerStateGeneration || cache.activeMainBuildable != activeMainBuildable ||
+		    cache.mainBuildable != mainBuildable || cache.BPVampire != g_BPVampire.Get()) {
+			cache.generation = powerStateGeneration;
+			cache.activeMainBuildable = activeMainBuildable;
+			cache.mainBuildable = mainBuildable;
+			cache.BPVampire = g_BPVampire.Get();
+			cache.powered.clear();
+			cache.unpowered.clear();
+			cache.unpoweredBuildableTotal = 0;
+
+			ForEntities<BuildableComponent>([&](Entity& entity, BuildableComponent& buildableComponent) {
+				if (G_Team(entity.oldEnt) != team) return;
+
+				// Never shut down the main buildable or miners.
+				if (entity.Get<MainBuildableComponent>()) return;
+				if (entity.Get<MiningComponent>()) return;
+
+				// Never shut down spawns.
+				// TODO: Refer to a SpawnerComponent here.
+				if (entity.Get<TelenodeComponent>() || entity.Get<EggComponent>()) return;
+
+				// Power off all buildables if there is no main buildable.
+				if (!activeMainBuildable) {
+					buildableComponent.SetPowerState(false);
+					return;
+				}
 
-			// Never shut down the main buildable or miners.
-			if (entity.Get<MainBuildableComponent>()) return;
-			if (entity.Get<MiningComponent>()) return;
+				if (g_BPVampire.Get()) {
+					buildableComponent.SetPowerState(true);
+					return;
+				}
 
-			// Never shut down spawns.
-			// TODO: Refer to a SpawnerComponent here.
-			if (entity.Get<TelenodeComponent>() || entity.Get<EggComponent>()) return;
+				// In order to make good a deficit, don't shut down buildables that have no cost.
+				int buildPoints = BG_Buildable(entity.oldEnt->s.modelindex)->buildPoints;
+				if (buildPoints <= 0) return;
 
-			// Power off all buildables if there is no main buildable.
-			if (!activeMainBuildable) {
-				buildableComponent.SetPowerState(false);
-				return;
-			}
+				powerSavingCandidate_t candidate{&entity, buildableComponent.MarkedForDeconstruction(),
+					buildableComponent.GetMarkTime(), G_DistanceToBase(entity.oldEnt), buildPoints};
 
-			if (g_BPVampire.Get()) {
-				buildableComponent.SetPowerState(true);
-				return;
-			}
+				if (!entity.oldEnt->powered) {
+					cache.unpowered.push_back(candidate);
+					cache.unpoweredBuildableTotal += buildPoints;
+				} else {
+					cache.powered.push_back(candidate);
+				}
+			});
 
-			// In order to make good a deficit, don't shut down buildables that have no cost.
-			if (BG_Buildable(entity.oldEnt->s.modelindex)->buildPoints <= 0) return;
-			if (!entity.oldEnt->powered) {
-				unpoweredBuildables.push_back(&entity);
-				unpoweredBuildableTotal += BG_Buildable(entity.oldEnt->s.modelindex)->buildPoints;
-			} else {
-				poweredBuildables.push_back(&entity);
-			}
-		});
+			// The candidates are only sorted once per change, not every frame.
+			std::sort(cache.powered.begin(), cache.powered.end(), CompareBuildablesForPowerSaving);
+			std::sort(cache.unpowered.begin(), cache.unpowered.end(), CompareBuildablesForPowerSaving);
+		}
 
 		// If there is no active main buildable, all buildables that can shut down already did so.
 		if (!activeMainBuildable) continue;
 
 		// Positive deficit means that we are over, and negative means we have a surplus.
-		int deficit = level.team[team].spentBudget - (int)level.team[team].totalBudget - unpoweredBuildableTotal;
+		int deficit = level.team[team].spentBudget - (int)level.team[team].totalBudget - cache.unpoweredBuildableTotal;
 
 		// Exactly at our limit. Nothing else to do.
 		if (deficit == 0) continue;
 
 		// We have surplus bp, but nothing else to power on, so we're done here.
-		if (deficit < 0 && unpoweredBuildables.empty()) continue;
+		if (deficit < 0 && cache.unpowered.empty()) continue;
+
+		// Changing power states invalidates the cache, so work on a copy of the candidates.
+		std::vector<powerSavingCandidate_t> candidates = deficit > 0 ? cache.powered : cache.unpowered;
 
 		// Uh oh...start powering stuff down.
 		if (deficit > 0) {
-			std::sort(poweredBuildables.begin(), poweredBuildables.end(), CompareBuildablesForPowerSaving);
-			for(Entity* entity : poweredBuildables) {
+			for (const powerSavingCandidate_t &candidate : candidates) {
+				Entity *entity = candidate.entity;
+
 				entity->Get<BuildableComponent>()->SetPowerState(false);
 
 				// Dying buildables have already substracted their share from the spent budget pool.
 				if (entity->Get<HealthComponent>()->Alive()) {
-					deficit -= BG_Buildable(entity->oldEnt->s.modelindex)->buildPoints;
+					deficit -= candidate.buildPoints;
 				}
 
 				if (deficit <= 0) break;
@@ -468,16 +534,15 @@ void G_UpdateBuildablePowerStates()
 		} else if (deficit < 0) {
 			// Make our deficit positive for ease of calculation.
 			int surplus = -deficit;
-			std::sort(unpoweredBuildables.begin(), unpoweredBuildables.end(), CompareBuildablesForPowerSaving);
-			for (auto it = unpoweredBuildables.rbegin(); it != unpoweredBuildables.rend(); ++it) {
-				int buildableCost = BG_Buildable((*it)->oldEnt->s.modelindex)->buildPoints;
+			for (auto it = candidates.rbegin(); it != candidates.rend(); ++it) {
+				int buildableCost = it->buildPoints;
 
 				// not cheap enough
 				if (surplus < buildableCost) continue;
 				// don't switch on unpowered buildables on destruction
-				if (!(*it)->Get<HealthComponent>()->Alive()) continue;
+				if (!it->entity->Get<HealthComponent>()->Alive()) continue;
 
-				(*it)->Get<BuildableComponent>()->SetPowerState(true);
+				it->entity->Get<BuildableComponent>()->SetPowerState(true);
 				surplus -= buildableCost;
 			}
 		}
@@ -510,7 +575,7 @@ void G_BuildableTouchTriggers( gentity_t *ent )
 	VectorSubtract( mins, range, mins );
 	VectorAdd( maxs, range, maxs );
 
-	num = trap_EntitiesInBox( mins, maxs, touch, MAX_GENTITIES );
+	num = G_TriggersInBox( mins, maxs, touch, MAX_GENTITIES );
 
 	VectorAdd( ent->s.origin, bmins, mins );
 	VectorAdd( ent->s.origin, bmaxs, maxs );
@@ -576,6 +641,35 @@ bool G_BuildableInRange( vec3_t origin, float radius, buildable_t buildable )
 	return false;
 }
 
+/**
+ * @return Whether client is close enough to an armoury to use it, like G_BuildableInRange but
+ *         only looking at the buildables the client was assigned to this frame.
+ */
+bool G_ArmouryInRange( gentity_t *client )
+{
+	glm::vec3 origin = VEC2GLM( client->client->ps.origin );
+
+	for ( gentity_t *neighbor : G_ServiceProviders( client ) )
+	{
+		if ( !neighbor->inuse || neighbor->s.eType != entityType_t::ET_BUILDABLE ||
+		     neighbor->s.modelindex != BA_H_ARMOURY || !neighbor->spawned ||
+		     Entities::IsDead( neighbor ) || !neighbor->powered )
+		{
+			continue;
+		}
+
+		glm::vec3 center = VEC2GLM( neighbor->r.currentOrigin ) +
+		                   ( VEC2GLM( neighbor->r.mins ) + VEC2GLM( neighbor->r.maxs ) ) * 0.5f;
+
+		if ( glm::distance( origin, center ) <= ENTITY_USE_RANGE )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 /**
  * @return Whether two buildables built at the given locations would intersect.
  */
@@ -1205,32 +1299,177 @@ static void SetBuildableMarkedLinkState( bool link )
 	}
 }
 
-itemBuildError_t G_CanBuild( gentity_t *ent, buildable_t buildable, int /*distance*/, //TODO
-                             vec3_t origin, vec3_t normal, int *groundEntNum )
+static Cvar::Cvar<bool> g_buildPreviewCache("g_buildPreviewCache", "reuse a builder's ghost placement while nothing it was traced against has changed", Cvar::NONE, true);
+
+/**
+ * @brief Where a builder's buildable would end up, as found by the placement traces.
+ */
+struct buildPlacement_t
 {
-	vec3_t           angles;
-	vec3_t           entity_origin;
-	vec3_t           mins, maxs;
-	trace_t          tr1, tr2, tr3;
-	itemBuildError_t reason = IBE_NONE;
-	gentity_t        *tempent;
-	float            minNormal;
-	bool         invert;
-	int              contents;
-	playerState_t    *ps = &ent->client->ps;
+	vec3_t origin;
+	vec3_t normal;
+	int    groundEntNum;
+	int    groundContents;
+	int    pointContents;
+	bool   blocked;
+};
+
+/**
+ * @brief A linked entity the placement traces may have collided with.
+ */
+struct placementObstacle_t
+{
+	int    number;
+	int    contents;
+	vec3_t absmin, absmax;
+	vec3_t origin, angles;
+};
+
+/**
+ * @brief The last ghost placement of a builder and everything it was computed from.
+ */
+struct buildPreview_t
+{
+	bool                             valid;
+	buildable_t                      buildable;
+	int                              classNum;
+	vec3_t                           playerOrigin, viewAngles, playerNormal;
+	vec3_t                           mins, maxs; // region reached by the placement traces
+	buildPlacement_t                 placement;
+	std::vector<placementObstacle_t> obstacles;
+};
+
+static buildPreview_t buildPreviews[ MAX_CLIENTS ];
+
+void G_ResetBuildPreviews()
+{
+	for ( buildPreview_t &preview : buildPreviews )
+	{
+		preview.valid = false;
+		preview.obstacles.clear();
+	}
+}
+
+/**
+ * @brief Traces where a buildable would be placed. Buildables are ignored by these traces.
+ */
+static void FindBuildablePlacement( gentity_t *ent, buildable_t buildable, buildPlacement_t &placement )
+{
+	vec3_t        angles;
+	vec3_t        mins, maxs;
+	trace_t       tr1, tr2, tr3;
+	playerState_t *ps = &ent->client->ps;
 
 	// Stop all buildables from interacting with traces
 	SetBuildableLinkState( false );
 
 	BG_BuildableBoundingBox( buildable, mins, maxs );
 
-	BG_PositionBuildableRelativeToPlayer( ps, mins, maxs, trap_Trace, entity_origin, angles, &tr1 );
-	trap_Trace( &tr2, entity_origin, mins, maxs, entity_origin, ENTITYNUM_NONE, MASK_PLAYERSOLID, 0 );
-	trap_Trace( &tr3, ps->origin, nullptr, nullptr, entity_origin, ent->num(), MASK_PLAYERSOLID, 0 );
+	BG_PositionBuildableRelativeToPlayer( ps, mins, maxs, trap_Trace, placement.origin, angles, &tr1 );
+	trap_Trace( &tr2, placement.origin, mins, maxs, placement.origin, ENTITYNUM_NONE, MASK_PLAYERSOLID, 0 );
+	trap_Trace( &tr3, ps->origin, nullptr, nullptr, placement.origin, ent->num(), MASK_PLAYERSOLID, 0 );
+
+	placement.groundEntNum = tr1.entityNum;
+	VectorCopy( tr1.plane.normal, placement.normal );
+	placement.groundContents = tr1.contents;
+	placement.pointContents = G_CM_PointContents( placement.origin, -1 );
+	placement.blocked = ( tr2.fraction < 1.0f || tr3.fraction < 1.0f );
 
-	VectorCopy( entity_origin, origin );
-	*groundEntNum = tr1.entityNum;
-	VectorCopy( tr1.plane.normal, normal );
+	// Relink buildables
+	SetBuildableLinkState( true );
+}
+
+/**
+ * @brief A box around the player that holds every trace of FindBuildablePlacement.
+ */
+static void BuildablePlacementRegion( const playerState_t *ps, buildable_t buildable, vec3_t mins, vec3_t maxs )
+{
+	vec3_t buildableMins, buildableMaxs;
+	float  extent = 0.0f;
+
+	BG_BuildableBoundingBox( buildable, buildableMins, buildableMaxs );
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		extent = std::max( extent, std::max( fabsf( buildableMins[ i ] ), fabsf( buildableMaxs[ i ] ) ) );
+	}
+
+	// the placement sweep starts 32 units above and ends 128 units below the build spot
+	float reach = fabsf( BG_Class( ps->stats[ STAT_CLASS ] )->buildDist ) + 128.0f + extent + 1.0f;
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		mins[ i ] = ps->origin[ i ] - reach;
+		maxs[ i ] = ps->origin[ i ] + reach;
+	}
+}
+
+/**
+ * @brief Lists the non-buildable entities in a region that traces or point contents could hit.
+ */
+static void CollectPlacementObstacles( const vec3_t mins, const vec3_t maxs, std::vector<placementObstacle_t> &obstacles )
+{
+	int entityList[ MAX_GENTITIES ];
+	int num = trap_EntitiesInBox( mins, maxs, entityList, MAX_GENTITIES );
+
+	obstacles.clear();
+
+	for ( int i = 0; i < num; i++ )
+	{
+		const gentity_t *other = &g_entities[ entityList[ i ] ];
+
+		if ( other->s.eType == entityType_t::ET_BUILDABLE || !other->r.contents )
+		{
+			continue;
+		}
+
+		placementObstacle_t obstacle;
+		obstacle.number = entityList[ i ];
+		obstacle.contents = other->r.contents;
+		VectorCopy( other->r.absmin, obstacle.absmin );
+		VectorCopy( other->r.absmax, obstacle.absmax );
+		VectorCopy( other->r.currentOrigin, obstacle.origin );
+		VectorCopy( other->r.currentAngles, obstacle.angles );
+		obstacles.push_back( obstacle );
+	}
+}
+
+static bool SamePlacementObstacles( const std::vector<placementObstacle_t> &a, const std::vector<placementObstacle_t> &b )
+{
+	if ( a.size() != b.size() )
+	{
+		return false;
+	}
+
+	for ( size_t i = 0; i < a.size(); i++ )
+	{
+		if ( a[ i ].number != b[ i ].number || a[ i ].contents != b[ i ].contents ||
+		     !VectorCompare( a[ i ].absmin, b[ i ].absmin ) || !VectorCompare( a[ i ].absmax, b[ i ].absmax ) ||
+		     !VectorCompare( a[ i ].origin, b[ i ].origin ) || !VectorCompare( a[ i ].angles, b[ i ].angles ) )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief Applies the build rules to a placement. These depend on build points, buildable health
+ *        and cvars, so they are evaluated every time.
+ */
+static itemBuildError_t CheckBuildablePlacement( gentity_t *ent, buildable_t buildable, const buildPlacement_t &placement,
+                                                 vec3_t origin, vec3_t normal, int *groundEntNum )
+{
+	itemBuildError_t reason = IBE_NONE;
+	gentity_t        *tempent;
+	float            minNormal;
+	bool         invert;
+	int              contents;
+
+	VectorCopy( placement.origin, origin );
+	*groundEntNum = placement.groundEntNum;
+	VectorCopy( placement.normal, normal );
 	minNormal = BG_Buildable( buildable )->minNormal;
 	invert = BG_Buildable( buildable )->invertNormal;
 
@@ -1240,12 +1479,12 @@ itemBuildError_t G_CanBuild( gentity_t *ent, buildable_t buildable, int /*distan
 		reason = IBE_NORMAL;
 	}
 
-	if ( tr1.entityNum != ENTITYNUM_WORLD )
+	if ( placement.groundEntNum != ENTITYNUM_WORLD )
 	{
 		reason = IBE_NORMAL;
 	}
 
-	contents = G_CM_PointContents( entity_origin, -1 );
+	contents = placement.pointContents;
 
 	// Prepare replacement of other buildables.
 	itemBuildError_t replacementError;
@@ -1265,7 +1504,7 @@ itemBuildError_t G_CanBuild( gentity_t *ent, buildable_t buildable, int /*distan
 		}
 
 		// Check surface permissions
-		bool invalid = (tr1.contents & (CUSTOM_CONTENTS_NOALIENBUILD | CUSTOM_CONTENTS_NOBUILD)) || (contents & (CUSTOM_CONTENTS_NOALIENBUILD | CUSTOM_CONTENTS_NOBUILD));
+		bool invalid = (placement.groundContents & (CUSTOM_CONTENTS_NOALIENBUILD | CUSTOM_CONTENTS_NOBUILD)) || (contents & (CUSTOM_CONTENTS_NOALIENBUILD | CUSTOM_CONTENTS_NOBUILD));
 		if ( invalid && !g_ignoreNobuild.Get() )
 		{
 			reason = IBE_SURFACE;
@@ -1289,7 +1528,7 @@ itemBuildError_t G_CanBuild( gentity_t *ent, buildable_t buildable, int /*distan
 		}
 
 		// Check permissions
-		bool invalid = (tr1.contents & (CUSTOM_CONTENTS_NOHUMANBUILD | CUSTOM_CONTENTS_NOBUILD)) || (contents & (CUSTOM_CONTENTS_NOHUMANBUILD | CUSTOM_CONTENTS_NOBUILD));
+		bool invalid = (placement.groundContents & (CUSTOM_CONTENTS_NOHUMANBUILD | CUSTOM_CONTENTS_NOBUILD)) || (contents & (CUSTOM_CONTENTS_NOHUMANBUILD | CUSTOM_CONTENTS_NOBUILD));
 		if ( invalid && !g_ignoreNobuild.Get() )
 		{
 			reason = IBE_SURFACE;
@@ -1326,9 +1565,6 @@ itemBuildError_t G_CanBuild( gentity_t *ent, buildable_t buildable, int /*distan
 		}
 	}
 
-	// Relink buildables
-	SetBuildableLinkState( true );
-
 	// Check there is enough room to spawn from, if trying to build a spawner.
 	if ( reason == IBE_NONE )
 	{
@@ -1360,7 +1596,7 @@ itemBuildError_t G_CanBuild( gentity_t *ent, buildable_t buildable, int /*distan
 	}
 
 	//this item does not fit here
-	if ( tr2.fraction < 1.0f || tr3.fraction < 1.0f )
+	if ( placement.blocked )
 	{
 		reason = IBE_NOROOM;
 	}
@@ -1390,6 +1626,66 @@ itemBuildError_t G_CanBuild( gentity_t *ent, buildable_t buildable, int /*distan
 	return reason;
 }
 
+itemBuildError_t G_CanBuild( gentity_t *ent, buildable_t buildable, int /*distance*/, //TODO
+                             vec3_t origin, vec3_t normal, int *groundEntNum )
+{
+	buildPlacement_t placement;
+
+	FindBuildablePlacement( ent, buildable, placement );
+
+	return CheckBuildablePlacement( ent, buildable, placement, origin, normal, groundEntNum );
+}
+
+/**
+ * @brief Like G_CanBuild, for the ghost buildable shown to a builder every frame.
+ *
+ * The placement traces are reused as long as the builder has not moved or turned and no entity
+ * they could have hit has changed. The build rules are always checked again.
+ */
+itemBuildError_t G_CanBuildPreview( gentity_t *ent, buildable_t buildable, vec3_t origin, vec3_t normal, int *groundEntNum )
+{
+	static std::vector<placementObstacle_t> obstacles;
+	playerState_t  *ps = &ent->client->ps;
+	buildPreview_t &preview = buildPreviews[ ent->num() ];
+	vec3_t         playerNormal;
+
+	if ( !g_buildPreviewCache.Get() )
+	{
+		preview.valid = false;
+		return G_CanBuild( ent, buildable, 0, origin, normal, groundEntNum );
+	}
+
+	BG_GetClientNormal( ps, playerNormal );
+
+	bool reuse = preview.valid && preview.buildable == buildable &&
+	             preview.classNum == ps->stats[ STAT_CLASS ] &&
+	             VectorCompare( preview.playerOrigin, ps->origin ) &&
+	             VectorCompare( preview.viewAngles, ps->viewangles ) &&
+	             VectorCompare( preview.playerNormal, playerNormal );
+
+	if ( reuse )
+	{
+		CollectPlacementObstacles( preview.mins, preview.maxs, obstacles );
+		reuse = SamePlacementObstacles( obstacles, preview.obstacles );
+	}
+
+	if ( !reuse )
+	{
+		preview.valid = true;
+		preview.buildable = buildable;
+		preview.classNum = ps->stats[ STAT_CLASS ];
+		VectorCopy( ps->origin, preview.playerOrigin );
+		VectorCopy( ps->viewangles, preview.viewAngles );
+		VectorCopy( playerNormal, preview.playerNormal );
+		BuildablePlacementRegion( ps, buildable, preview.mins, preview.maxs );
+
+		FindBuildablePlacement( ent, buildable, preview.placement );
+		CollectPlacementObstacles( preview.mins, preview.maxs, preview.obstacles );
+	}
+
+	return CheckBuildablePlacement( ent, buildable, preview.placement, origin, normal, groundEntNum );
+}
+
 /** Sets shared buildable entity parameters. */
 #define BUILDABLE_ENTITY_SET_PARAMS(params)\
 	params.oldEnt = ent;\
@@ -1523,7 +1819,7 @@ static gentity_t *SpawnBuildable( gentity_t *builder, buildable_t buildable, con
 
 	built->s.eType = entityType_t::ET_BUILDABLE;
 	built->killedBy = ENTITYNUM_NONE;
-	built->classname = BG_strdup( attr->entityName );
+	G_SetClassname( built, attr->entityName );
 	built->s.modelindex = buildable;
 	built->s.modelindex2 = attr->team;
 	built->buildableTeam = (team_t) built->s.modelindex2;
@@ -2386,8 +2682,6 @@ void G_BuildLogRevert( int id )
 
 	for ( int team = TEAM_NONE + 1; team < NUM_TEAMS; ++team )
 	{
-		G_AddMomentumGenericStep( (team_t) team, momentumChange[ team ] );
+		G_AddMomentumGeneric( (team_t) team, momentumChange[ team ] );
 	}
-
-	G_AddMomentumEnd();
 }
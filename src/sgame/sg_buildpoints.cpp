@@ -54,11 +54,14 @@ float G_RGSPredictEfficiencyDelta(vec3_t origin, team_t team) {
 
 	buildpointLogger.Debug("Predicted efficiency of new miner itself: %f.", delta);
 
-	ForEntities<MiningComponent>([&] (Entity& miner, MiningComponent&) {
-		if (G_Team(miner.oldEnt) != team) return;
+	// Miners out of range lose nothing, so only the neighbors need to be summed up.
+	for (MiningComponent* neighbor : MiningComponent::FindNeighbors(VEC2GLM(origin))) {
+		Entity& miner = neighbor->entity;
+
+		if (G_Team(miner.oldEnt) != team) continue;
 
 		delta += RGSPredictEfficiencyLoss(miner, origin);
-	});
+	}
 
 	buildpointLogger.Debug("Predicted efficiency delta: %f. Build point delta: %f.", delta,
 	                       delta * g_buildPointBudgetPerMiner.Get());
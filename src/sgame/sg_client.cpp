@@ -443,11 +443,11 @@ static void SpawnCorpse( gentity_t *ent )
 
 	if ( ent->client->pers.team == TEAM_HUMANS )
 	{
-		body->classname = BG_strdup( "humanCorpse" );
+		G_SetClassname( body, "humanCorpse" );
 	}
 	else
 	{
-		body->classname = BG_strdup( "alienCorpse" );
+		G_SetClassname( body, "alienCorpse" );
 	}
 
 	body->s.misc = MAX_CLIENTS;
@@ -1617,7 +1617,7 @@ void ClientSpawn( gentity_t *ent, gentity_t *spawn, const vec3_t origin, const v
 
 	ent->s.groundEntityNum = ENTITYNUM_NONE;
 	ent->client = &level.clients[ index ];
-	ent->classname = BG_strdup( S_PLAYER_CLASSNAME );
+	G_SetClassname( ent, S_PLAYER_CLASSNAME );
 	if ( client->noclip )
 	{
 		client->cliprcontents = CONTENTS_BODY;
@@ -1853,7 +1853,7 @@ void ClientDisconnect( int clientNum )
 	ent->client->ps.persistant[ PERS_SPECSTATE ] = SPECTATOR_NOT;
 
 	G_FreeEntity(ent);
-	ent->classname = BG_strdup( "disconnected" );
+	G_SetClassname( ent, "disconnected" );
 	ent->client = level.clients + clientNum;
 
 	trap_SetConfigstring( CS_PLAYERS + clientNum, "" );
@@ -47,6 +47,33 @@ struct worldEntity_t
 
 worldEntity_t wentities[ MAX_GENTITIES ];
 
+// bumped whenever an entity is linked or unlinked, see G_CM_WorldChanges
+static int worldChanges;
+
+// bumped whenever a trigger is linked or unlinked, see G_CM_TriggerChanges
+static int triggerChanges;
+
+// the entities within an area, looked up once for all the traces inside it, see G_CM_BeginTraceArea
+struct traceArea_t
+{
+	bool             active;
+	vec3_t           mins, maxs;
+	std::vector<int> entities;
+	std::vector<int> changed; // linked or unlinked since the entities were looked up
+	bool             logged[ MAX_GENTITIES ];
+};
+
+static traceArea_t traceArea;
+
+static void G_CM_TraceAreaChanged( int num )
+{
+	if ( traceArea.active && !traceArea.logged[ num ] )
+	{
+		traceArea.logged[ num ] = true;
+		traceArea.changed.push_back( num );
+	}
+}
+
 static worldEntity_t *G_CM_WorldEntityForGentity( gentity_t *gEnt )
 {
 	if ( !gEnt || gEnt->num() < 0 || gEnt->num() >= MAX_GENTITIES )
@@ -339,6 +366,8 @@ void G_CM_ClearWorld()
 	memset( sv_worldSectors, 0, sizeof( sv_worldSectors ) );
 	memset( wentities, 0, sizeof( wentities ) );
 	sv_numworldSectors = 0;
+	triggerChanges++;
+	G_CM_EndTraceArea();
 
 	// get world map bounds
 	h = CM_InlineModel( 0 );
@@ -357,8 +386,12 @@ void G_CM_UnlinkEntity( gentity_t *gEnt )
 	worldEntity_t* scan;
 	worldSector_t* ws;
 
+	worldChanges++;
+
 	worldEntity_t* went = G_CM_WorldEntityForGentity( gEnt );
 
+	G_CM_TraceAreaChanged( gEnt->num() );
+
 	gEnt->r.linked = false;
 
 	ws = went->worldSector;
@@ -368,6 +401,11 @@ void G_CM_UnlinkEntity( gentity_t *gEnt )
 		return; // not linked in anywhere
 	}
 
+	if ( gEnt->r.contents & CONTENTS_TRIGGER )
+	{
+		triggerChanges++;
+	}
+
 	went->worldSector = nullptr;
 
 	if ( ws->entities == went )
@@ -407,10 +445,21 @@ void G_CM_LinkEntity( gentity_t *gEnt )
 
 	worldEntity_t* went = G_CM_WorldEntityForGentity( gEnt );
 
+	// a relink counts as a single change, the unlink already bumps worldChanges
 	if ( went->worldSector )
 	{
 		G_CM_UnlinkEntity( gEnt );  // unlink from old position
 	}
+	else
+	{
+		worldChanges++;
+		G_CM_TraceAreaChanged( gEnt->num() );
+	}
+
+	if ( gEnt->r.contents & CONTENTS_TRIGGER )
+	{
+		triggerChanges++;
+	}
 
 	// encode the size into the entityState_t for client prediction
 	if ( gEnt->r.bmodel )
@@ -661,6 +710,65 @@ static void G_CM_AreaEntities_r( worldSector_t *node, areaParms_t *ap )
 	}
 }
 
+/*
+====================
+G_CM_LinkedTriggers_r
+
+Visits the sectors in the same order as G_CM_AreaEntities_r
+====================
+*/
+static void G_CM_LinkedTriggers_r( worldSector_t *node, int *list, int maxcount, int *count )
+{
+	for ( worldEntity_t *check = node->entities; check; check = check->nextEntityInWorldSector )
+	{
+		gentity_t *gcheck = G_CM_GEntityForWorldEntity( check );
+
+		if ( !gcheck->r.linked || !( gcheck->r.contents & CONTENTS_TRIGGER ) )
+		{
+			continue;
+		}
+
+		if ( *count == maxcount )
+		{
+			return;
+		}
+
+		list[ ( *count )++ ] = check - wentities;
+	}
+
+	if ( node->axis == -1 )
+	{
+		return; // terminal node
+	}
+
+	G_CM_LinkedTriggers_r( node->children[ 0 ], list, maxcount, count );
+	G_CM_LinkedTriggers_r( node->children[ 1 ], list, maxcount, count );
+}
+
+/*
+================
+G_CM_LinkedTriggers
+================
+*/
+int G_CM_LinkedTriggers( int *entityList, int maxcount )
+{
+	int count = 0;
+
+	G_CM_LinkedTriggers_r( sv_worldSectors, entityList, maxcount, &count );
+
+	return count;
+}
+
+/*
+================
+G_CM_TriggerChanges
+================
+*/
+int G_CM_TriggerChanges()
+{
+	return triggerChanges;
+}
+
 /*
 ================
 G_CM_AreaEntities
@@ -681,6 +789,55 @@ int G_CM_AreaEntities( const vec3_t mins, const vec3_t maxs, int *entityList, in
 	return ap.count;
 }
 
+/*
+================
+G_CM_LookUpTraceArea
+================
+*/
+static void G_CM_LookUpTraceArea()
+{
+	traceArea.entities.resize( MAX_GENTITIES );
+	traceArea.entities.resize( G_CM_AreaEntities( traceArea.mins, traceArea.maxs, traceArea.entities.data(), MAX_GENTITIES ) );
+
+	for ( int num : traceArea.changed )
+	{
+		traceArea.logged[ num ] = false;
+	}
+
+	traceArea.changed.clear();
+}
+
+/*
+================
+G_CM_BeginTraceArea
+================
+*/
+void G_CM_BeginTraceArea( const vec3_t mins, const vec3_t maxs )
+{
+	VectorCopy( mins, traceArea.mins );
+	VectorCopy( maxs, traceArea.maxs );
+	traceArea.active = true;
+
+	G_CM_LookUpTraceArea();
+}
+
+/*
+================
+G_CM_EndTraceArea
+================
+*/
+void G_CM_EndTraceArea()
+{
+	for ( int num : traceArea.changed )
+	{
+		traceArea.logged[ num ] = false;
+	}
+
+	traceArea.changed.clear();
+	traceArea.entities.clear();
+	traceArea.active = false;
+}
+
 //===========================================================================
 
 struct moveclip_t
@@ -699,19 +856,16 @@ struct moveclip_t
 
 /*
 ====================
-G_CM_ClipMoveToEntities
+G_CM_ClipMoveToEntityList
 ====================
 */
-static void G_CM_ClipMoveToEntities( moveclip_t *clip )
+static void G_CM_ClipMoveToEntityList( moveclip_t *clip, const int *touchlist, int num )
 {
-	int            i, num;
-	int            touchlist[ MAX_GENTITIES ];
+	int            i;
 	gentity_t *touch;
 	trace_t        trace;
 	clipHandle_t   clipHandle;
 
-	num = G_CM_AreaEntities( clip->boxmins, clip->boxmaxs, touchlist, MAX_GENTITIES );
-
 	for ( i = 0; i < num; i++ )
 	{
 		if ( clip->trace.allsolid )
@@ -784,6 +938,156 @@ static void G_CM_ClipMoveToEntities( moveclip_t *clip )
 	}
 }
 
+/*
+====================
+G_CM_InTraceArea
+
+Returns true if the entities touching the box can be taken from the trace area.
+Entities linked or unlinked since the area was looked up may be missing from it or
+be listed out of order, so the area is looked up again as soon as one of them could
+be clipped against. The others have no contents and are skipped by the clip anyway.
+====================
+*/
+static bool G_CM_InTraceArea( const vec3_t boxmins, const vec3_t boxmaxs )
+{
+	if ( !traceArea.active )
+	{
+		return false;
+	}
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		if ( boxmins[ i ] < traceArea.mins[ i ] || boxmaxs[ i ] > traceArea.maxs[ i ] )
+		{
+			return false;
+		}
+	}
+
+	for ( int num : traceArea.changed )
+	{
+		if ( g_entities[ num ].r.contents )
+		{
+			G_CM_LookUpTraceArea();
+			break;
+		}
+	}
+
+	return true;
+}
+
+/*
+====================
+G_CM_TouchEntities
+
+Lists the entities a move within the box may touch, like G_CM_AreaEntities.
+====================
+*/
+static int G_CM_TouchEntities( const vec3_t boxmins, const vec3_t boxmaxs, int *touchlist )
+{
+	if ( !G_CM_InTraceArea( boxmins, boxmaxs ) )
+	{
+		return G_CM_AreaEntities( boxmins, boxmaxs, touchlist, MAX_GENTITIES );
+	}
+
+	int num = 0;
+
+	// the same tests G_CM_AreaEntities_r does, which visits the sectors in the same order
+	for ( int entityNum : traceArea.entities )
+	{
+		const gentity_t *check = &g_entities[ entityNum ];
+
+		if ( !check->r.linked
+		     || check->r.absmin[ 0 ] > boxmaxs[ 0 ]
+		     || check->r.absmin[ 1 ] > boxmaxs[ 1 ]
+		     || check->r.absmin[ 2 ] > boxmaxs[ 2 ]
+		     || check->r.absmax[ 0 ] < boxmins[ 0 ]
+		     || check->r.absmax[ 1 ] < boxmins[ 1 ]
+		     || check->r.absmax[ 2 ] < boxmins[ 2 ] )
+		{
+			continue;
+		}
+
+		touchlist[ num++ ] = entityNum;
+	}
+
+	return num;
+}
+
+/*
+====================
+G_CM_ClipMoveToEntities
+====================
+*/
+static void G_CM_ClipMoveToEntities( moveclip_t *clip )
+{
+	int touchlist[ MAX_GENTITIES ];
+	int num = G_CM_TouchEntities( clip->boxmins, clip->boxmaxs, touchlist );
+
+	G_CM_ClipMoveToEntityList( clip, touchlist, num );
+}
+
+/*
+==================
+G_CM_BeginTrace
+
+Clips the move to the world and prepares clipping it to the entities.
+mins and maxs must not be null and must outlive clip.
+Returns false if the world already blocks the whole move.
+==================
+*/
+static bool G_CM_BeginTrace( moveclip_t *clip, const vec3_t start, const vec3_t mins, const vec3_t maxs,
+                             const vec3_t end, int passEntityNum, int contentmask, int skipmask,
+                             traceType_t type )
+{
+	int i;
+
+	*clip = {};
+
+	// clip to world
+	// -------------
+
+	CM_BoxTrace( &clip->trace, start, end, mins, maxs, 0, contentmask, skipmask, type );
+	clip->trace.entityNum = clip->trace.fraction == 1.0 ? ENTITYNUM_NONE : ENTITYNUM_WORLD;
+
+	if ( clip->trace.allsolid )
+	{
+		return false; // blocked immediately by the world
+	}
+
+	// clip to entities
+	// ----------------
+
+	clip->contentmask = contentmask;
+	clip->skipmask = skipmask;
+	clip->start = start;
+//  VectorCopy( clip->trace.endpos, clip->end );
+	VectorCopy( end, clip->end );
+	clip->mins = mins;
+	clip->maxs = maxs;
+	clip->passEntityNum = passEntityNum;
+	clip->collisionType = type;
+
+	// create the bounding box of the entire move
+	// we can limit it to the part of the move not
+	// already clipped off by the world, which can be
+	// a significant savings for line of sight and shot traces
+	for ( i = 0; i < 3; i++ )
+	{
+		if ( end[ i ] > start[ i ] )
+		{
+			clip->boxmins[ i ] = clip->start[ i ] + clip->mins[ i ] - 1;
+			clip->boxmaxs[ i ] = clip->end[ i ] + clip->maxs[ i ] + 1;
+		}
+		else
+		{
+			clip->boxmins[ i ] = clip->end[ i ] + clip->mins[ i ] - 1;
+			clip->boxmaxs[ i ] = clip->start[ i ] + clip->maxs[ i ] + 1;
+		}
+	}
+
+	return true;
+}
+
 /*
 ==================
 G_CM_Trace
@@ -796,8 +1100,6 @@ void G_CM_Trace( trace_t *results, const vec3_t start, const vec3_t mins2, const
                  const vec3_t end, int passEntityNum, int contentmask, int skipmask,
                  traceType_t type )
 {
-	int        i;
-
 	if ( !mins2 )
 	{
 		mins2 = vec3_origin;
@@ -812,55 +1114,126 @@ void G_CM_Trace( trace_t *results, const vec3_t start, const vec3_t mins2, const
 	VectorCopy(mins2, mins);
 	VectorCopy(maxs2, maxs);
 
-	moveclip_t clip{};
+	moveclip_t clip;
 
-	// clip to world
-	// -------------
+	if ( G_CM_BeginTrace( &clip, start, mins, maxs, end, passEntityNum, contentmask, skipmask, type ) )
+	{
+		// clip to other solid entities
+		G_CM_ClipMoveToEntities( &clip );
+	}
 
-	CM_BoxTrace( &clip.trace, start, end, mins, maxs, 0, contentmask, skipmask, type );
-	clip.trace.entityNum = clip.trace.fraction == 1.0 ? ENTITYNUM_NONE : ENTITYNUM_WORLD;
+	*results = clip.trace;
+}
+
+/*
+==================
+G_CM_TraceVolley
 
-	if ( clip.trace.allsolid )
+Like a G_CM_Trace from start to each of ends, but looks the entities up only once
+for the whole volley. Every move then clips against the entities within its own
+bounds, in the order G_CM_AreaEntities would have listed them for that move alone,
+so the results are the same as tracing one by one.
+==================
+*/
+void G_CM_TraceVolley( trace_t *results, int count, const vec3_t start, const vec3_t mins2, const vec3_t maxs2,
+                       const glm::vec3 *ends, int passEntityNum, int contentmask, int skipmask,
+                       traceType_t type )
+{
+	static std::vector<moveclip_t> clips;
+	static std::vector<bool>       open;
+	int     volleyList[ MAX_GENTITIES ], touchlist[ MAX_GENTITIES ];
+	int     volleyCount = 0;
+	vec3_t  volleyMins, volleyMaxs;
+	bool    anyOpen = false;
+
+	if ( !mins2 )
 	{
-		*results = clip.trace;
-		return; // blocked immediately by the world
+		mins2 = vec3_origin;
 	}
 
-	// clip to entities
-	// ----------------
+	if ( !maxs2 )
+	{
+		maxs2 = vec3_origin;
+	}
 
-	clip.contentmask = contentmask;
-	clip.skipmask = skipmask;
-	clip.start = start;
-//  VectorCopy( clip.trace.endpos, clip.end );
-	VectorCopy( end, clip.end );
-	clip.mins = mins;
-	clip.maxs = maxs;
-	clip.passEntityNum = passEntityNum;
-	clip.collisionType = type;
+	vec3_t mins, maxs;
+	VectorCopy(mins2, mins);
+	VectorCopy(maxs2, maxs);
 
-	// create the bounding box of the entire move
-	// we can limit it to the part of the move not
-	// already clipped off by the world, which can be
-	// a significant savings for line of sight and shot traces
-	for ( i = 0; i < 3; i++ )
+	clips.resize( count );
+	open.assign( count, false );
+
+	for ( int i = 0; i < count; i++ )
 	{
-		if ( end[ i ] > start[ i ] )
+		if ( !G_CM_BeginTrace( &clips[ i ], start, mins, maxs, GLM4READ( ends[ i ] ), passEntityNum, contentmask, skipmask, type ) )
 		{
-			clip.boxmins[ i ] = clip.start[ i ] + clip.mins[ i ] - 1;
-			clip.boxmaxs[ i ] = clip.end[ i ] + clip.maxs[ i ] + 1;
+			continue;
+		}
+
+		open[ i ] = true;
+
+		if ( !anyOpen )
+		{
+			VectorCopy( clips[ i ].boxmins, volleyMins );
+			VectorCopy( clips[ i ].boxmaxs, volleyMaxs );
+			anyOpen = true;
 		}
 		else
 		{
-			clip.boxmins[ i ] = clip.end[ i ] + clip.mins[ i ] - 1;
-			clip.boxmaxs[ i ] = clip.start[ i ] + clip.maxs[ i ] + 1;
+			AddPointToBounds( clips[ i ].boxmins, volleyMins, volleyMaxs );
+			AddPointToBounds( clips[ i ].boxmaxs, volleyMins, volleyMaxs );
 		}
 	}
 
-	// clip to other solid entities
-	G_CM_ClipMoveToEntities( &clip );
+	if ( anyOpen )
+	{
+		volleyCount = G_CM_AreaEntities( volleyMins, volleyMaxs, volleyList, MAX_GENTITIES );
+	}
 
-	*results = clip.trace;
+	for ( int i = 0; i < count; i++ )
+	{
+		moveclip_t *clip = &clips[ i ];
+
+		if ( open[ i ] )
+		{
+			// the same test G_CM_AreaEntities_r does, which visits the sectors in the same order
+			int num = 0;
+
+			for ( int j = 0; j < volleyCount; j++ )
+			{
+				const gentity_t *check = &g_entities[ volleyList[ j ] ];
+
+				if ( check->r.absmin[ 0 ] > clip->boxmaxs[ 0 ]
+				     || check->r.absmin[ 1 ] > clip->boxmaxs[ 1 ]
+				     || check->r.absmin[ 2 ] > clip->boxmaxs[ 2 ]
+				     || check->r.absmax[ 0 ] < clip->boxmins[ 0 ]
+				     || check->r.absmax[ 1 ] < clip->boxmins[ 1 ]
+				     || check->r.absmax[ 2 ] < clip->boxmins[ 2 ] )
+				{
+					continue;
+				}
+
+				touchlist[ num++ ] = volleyList[ j ];
+			}
+
+			G_CM_ClipMoveToEntityList( clip, touchlist, num );
+		}
+
+		results[ i ] = clip->trace;
+	}
+}
+
+/*
+==================
+G_CM_WorldChanges
+
+Changes whenever an entity is linked or unlinked, so callers holding on to trace
+results can tell whether they might be out of date.
+==================
+*/
+int G_CM_WorldChanges()
+{
+	return worldChanges;
 }
 
 static trace2_t ConvertTrace( const trace_t &tr, const vec3_t start, int entityNum )
@@ -934,7 +1307,7 @@ trace2_t G_Trace2( const vec3_t start, const vec3_t mins, const vec3_t maxs, con
 		}
 	}
 
-	int num = G_CM_AreaEntities( boxmins, boxmaxs, touchlist, MAX_GENTITIES );
+	int num = G_CM_TouchEntities( boxmins, boxmaxs, touchlist );
 
 	for ( int i = 0; i < num; i++ )
 	{
@@ -69,6 +69,22 @@ int          G_CM_AreaEntities( const vec3_t mins, const vec3_t maxs, int *entit
 // returns the number of pointers filled in
 // The world entity is never returned in this list.
 
+int          G_CM_LinkedTriggers( int *entityList, int maxcount );
+
+// fills in a table of all linked trigger entities, in the order G_CM_AreaEntities
+// would return them for any area that contains them.
+
+int          G_CM_TriggerChanges();
+
+// changes whenever a trigger entity is linked or unlinked
+
+void         G_CM_BeginTraceArea( const vec3_t mins, const vec3_t maxs );
+void         G_CM_EndTraceArea();
+
+// traces whose moves lie within the area take their entities from a single
+// G_CM_AreaEntities over it instead of looking them up one by one.
+// The results are the same either way.
+
 int G_CM_PointContents( const vec3_t p, int passEntityNum );
 
 // returns the CONTENTS_* value from the world and all entities at the given point.
@@ -87,6 +103,16 @@ void G_CM_Trace( trace_t *results, const vec3_t start, const vec3_t mins, const
 
 // passEntityNum, if isn't ENTITYNUM_NONE, will be explicitly excluded from clipping checks
 
+void G_CM_TraceVolley( trace_t *results, int count, const vec3_t start, const vec3_t mins, const vec3_t maxs,
+                       const glm::vec3 *ends, int passEntityNum, int contentmask, int skipmask,
+                       traceType_t type );
+
+// count G_CM_Traces from the same start, looking the entities up once for all of them
+
+int G_CM_WorldChanges();
+
+// changes whenever an entity is linked or unlinked
+
 
 // G_Trace2: an alternative to trap_Trace (a.k.a. G_CM_Trace) with different startsolid semantics
 // In a standard trace, if there is a brush/entity/facet that overlaps the starting point but not
@@ -35,6 +35,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "engine/qcommon/q_unicode.h"
 #include "botlib/bot_api.h"
 #include <common/FileSystem.h>
+#include <chrono>
 #include "Entities.h"
 #include "CBSE.h"
 #include "sg_votes.h"
@@ -2560,7 +2561,7 @@ static bool Cmd_Sell_internal( gentity_t *ent, const char *s )
 	upgrade_t upgrade;
 
 	//no armoury nearby
-	if ( !G_BuildableInRange( ent->client->ps.origin, ENTITY_USE_RANGE, BA_H_ARMOURY ) )
+	if ( !G_ArmouryInRange( ent ) )
 	{
 		G_TriggerMenu( ent->client->ps.clientNum, MN_H_NOARMOURYHERE );
 		return false;
@@ -2716,7 +2717,7 @@ static bool Cmd_Buy_internal( gentity_t *ent, const char *s, bool sellConflictin
 	upgrade = BG_UpgradeByName( s )->number;
 
 	// check if armoury is in reach
-	if ( !G_BuildableInRange( ent->client->ps.origin, ENTITY_USE_RANGE, BA_H_ARMOURY ) )
+	if ( !G_ArmouryInRange( ent ) )
 	{
 		G_TriggerMenu( ent->client->ps.clientNum, MN_H_NOARMOURYHERE );
 
@@ -4262,61 +4263,143 @@ static void Cmd_ReplyPrivateMessage_f( gentity_t *ent )
 // keep the list synchronized with the list in cg_consolecmds for completion.
 static const commands_t cmds[] =
 {
-	{ "a",               CMD_MESSAGE | CMD_INTERMISSION,      Cmd_AdminMessage_f     },
-	{ "asay",            CMD_MESSAGE | CMD_INTERMISSION,      Cmd_Say_f              },
-	{ "beacon",          CMD_TEAM | CMD_ALIVE,                Cmd_Beacon_f           },
-	{ "build",           CMD_TEAM | CMD_ALIVE,                Cmd_Build_f            },
-	{ "buy",             CMD_HUMAN | CMD_ALIVE,               Cmd_Buy_f              },
-	{ "callteamvote",    CMD_MESSAGE | CMD_TEAM,              Cmd_CallVote_f         },
-	{ "callvote",        CMD_MESSAGE,                         Cmd_CallVote_f         },
-	{ "class",           CMD_TEAM,                            Cmd_Class_f            },
-	{ "damage",          CMD_CHEAT | CMD_ALIVE,               Cmd_Damage_f           },
-	{ "deconstruct",     CMD_TEAM | CMD_ALIVE,                Cmd_Deconstruct_f      },
-	{ "devteam",         CMD_CHEAT,                           Cmd_Devteam_f          },
-	{ "follow",          CMD_SPEC,                            Cmd_Follow_f           },
-	{ "follownext",      CMD_SPEC,                            Cmd_FollowCycle_f      },
-	{ "followprev",      CMD_SPEC,                            Cmd_FollowCycle_f      },
-	{ "give",            CMD_CHEAT,                           Cmd_Give_f             },
-	{ "god",             CMD_CHEAT,                           Cmd_God_f              },
-	{ "ignite",          CMD_CHEAT | CMD_TEAM | CMD_ALIVE,    Cmd_Ignite_f           },
-	{ "ignore",          0,                                   Cmd_Ignore_f           },
-	{ "itemact",         CMD_HUMAN | CMD_ALIVE,               Cmd_ActivateItem_f     },
-	{ "itemdeact",       CMD_HUMAN | CMD_ALIVE,               Cmd_DeActivateItem_f   },
-	{ "itemtoggle",      CMD_HUMAN | CMD_ALIVE,               Cmd_ToggleItem_f       },
-	{ "kill",            CMD_TEAM | CMD_ALIVE,                Cmd_Kill_f             },
-	{ "listmaps",        CMD_MESSAGE | CMD_INTERMISSION,      Cmd_ListMaps_f         },
-	{ "listrotation",    CMD_MESSAGE | CMD_INTERMISSION,      G_PrintCurrentRotation },
-	{ "m",               CMD_MESSAGE | CMD_INTERMISSION,      Cmd_PrivateMessage_f   },
-	{ "maplog",          CMD_MESSAGE | CMD_INTERMISSION,      Cmd_MapLog_f           },
-	{ "me",              CMD_MESSAGE | CMD_INTERMISSION,      Cmd_Me_f               },
-	{ "me_team",         CMD_MESSAGE | CMD_INTERMISSION,      Cmd_Me_f               },
-	{ "mt",              CMD_MESSAGE | CMD_INTERMISSION,      Cmd_PrivateMessage_f   },
-	{ "noclip",          CMD_CHEAT_TEAM,                      Cmd_Noclip_f           },
-	{ "notarget",        CMD_CHEAT | CMD_TEAM | CMD_ALIVE,    Cmd_Notarget_f         },
-	{ "print_momentum",  CMD_CHEAT,                           Cmd_PrintMomentum_f    },
-	{ "pubkey_identify", CMD_INTERMISSION,                    Cmd_Pubkey_Identify_f  },
-	{ "r",               CMD_MESSAGE | CMD_INTERMISSION,      Cmd_ReplyPrivateMessage_f   },
-	{ "reload",          CMD_HUMAN | CMD_ALIVE,               Cmd_Reload_f           },
-	{ "say",             CMD_MESSAGE | CMD_INTERMISSION,      Cmd_Say_f              },
-	{ "say_area",        CMD_MESSAGE | CMD_TEAM | CMD_ALIVE,  Cmd_SayArea_f          },
-	{ "say_area_team",   CMD_MESSAGE | CMD_TEAM | CMD_ALIVE,  Cmd_SayAreaTeam_f      },
-	{ "say_team",        CMD_MESSAGE | CMD_INTERMISSION,      Cmd_Say_f              },
-	{ "score",           CMD_INTERMISSION,                    ScoreboardMessage      },
-	{ "sell",            CMD_HUMAN | CMD_ALIVE,               Cmd_Sell_f             },
-	{ "setviewpos",      CMD_CHEAT_TEAM,                      Cmd_SetViewpos_f       },
-	{ "tactic",          CMD_TEAM,                            Cmd_Tactic_f           },
-	{ "team",            0,                                   Cmd_Team_f             },
-	{ "teamstatus",      CMD_TEAM,                            Cmd_TeamStatus_f       },
-	{ "teamvote",        CMD_TEAM | CMD_INTERMISSION,         Cmd_Vote_f             },
-	{ "unignore",        0,                                   Cmd_Ignore_f           },
-	{ "vote",            CMD_INTERMISSION,                    Cmd_Vote_f             },
-	{ "vsay",            CMD_MESSAGE | CMD_INTERMISSION,      Cmd_VSay_f             },
-	{ "vsay_local",      CMD_MESSAGE | CMD_INTERMISSION,      Cmd_VSay_f             },
-	{ "vsay_team",       CMD_MESSAGE | CMD_INTERMISSION,      Cmd_VSay_f             },
-	{ "where",           0,                                   Cmd_Where_f            }
+	{ "a",               CMD_MESSAGE | CMD_INTERMISSION,      Cmd_AdminMessage_f,         CMD_COST_DEFAULT },
+	{ "asay",            CMD_MESSAGE | CMD_INTERMISSION,      Cmd_Say_f,                  CMD_COST_DEFAULT },
+	{ "beacon",          CMD_TEAM | CMD_ALIVE,                Cmd_Beacon_f,               CMD_COST_DEFAULT },
+	{ "build",           CMD_TEAM | CMD_ALIVE,                Cmd_Build_f,                CMD_COST_DEFAULT },
+	{ "buy",             CMD_HUMAN | CMD_ALIVE,               Cmd_Buy_f,                  CMD_COST_DEFAULT },
+	{ "callteamvote",    CMD_MESSAGE | CMD_TEAM,              Cmd_CallVote_f,             CMD_COST_HEAVY },
+	{ "callvote",        CMD_MESSAGE,                         Cmd_CallVote_f,             CMD_COST_HEAVY },
+	{ "class",           CMD_TEAM,                            Cmd_Class_f,                CMD_COST_DEFAULT },
+	{ "damage",          CMD_CHEAT | CMD_ALIVE,               Cmd_Damage_f,               CMD_COST_DEFAULT },
+	{ "deconstruct",     CMD_TEAM | CMD_ALIVE,                Cmd_Deconstruct_f,          CMD_COST_DEFAULT },
+	{ "devteam",         CMD_CHEAT,                           Cmd_Devteam_f,              CMD_COST_DEFAULT },
+	{ "follow",          CMD_SPEC,                            Cmd_Follow_f,               CMD_COST_DEFAULT },
+	{ "follownext",      CMD_SPEC,                            Cmd_FollowCycle_f,          CMD_COST_DEFAULT },
+	{ "followprev",      CMD_SPEC,                            Cmd_FollowCycle_f,          CMD_COST_DEFAULT },
+	{ "give",            CMD_CHEAT,                           Cmd_Give_f,                 CMD_COST_DEFAULT },
+	{ "god",             CMD_CHEAT,                           Cmd_God_f,                  CMD_COST_DEFAULT },
+	{ "ignite",          CMD_CHEAT | CMD_TEAM | CMD_ALIVE,    Cmd_Ignite_f,               CMD_COST_DEFAULT },
+	{ "ignore",          0,                                   Cmd_Ignore_f,               CMD_COST_DEFAULT },
+	{ "itemact",         CMD_HUMAN | CMD_ALIVE,               Cmd_ActivateItem_f,         CMD_COST_DEFAULT },
+	{ "itemdeact",       CMD_HUMAN | CMD_ALIVE,               Cmd_DeActivateItem_f,       CMD_COST_DEFAULT },
+	{ "itemtoggle",      CMD_HUMAN | CMD_ALIVE,               Cmd_ToggleItem_f,           CMD_COST_DEFAULT },
+	{ "kill",            CMD_TEAM | CMD_ALIVE,                Cmd_Kill_f,                 CMD_COST_DEFAULT },
+	{ "listmaps",        CMD_MESSAGE | CMD_INTERMISSION,      Cmd_ListMaps_f,             CMD_COST_HEAVY },
+	{ "listrotation",    CMD_MESSAGE | CMD_INTERMISSION,      G_PrintCurrentRotation,     CMD_COST_HEAVY },
+	{ "m",               CMD_MESSAGE | CMD_INTERMISSION,      Cmd_PrivateMessage_f,       CMD_COST_MEDIUM },
+	{ "maplog",          CMD_MESSAGE | CMD_INTERMISSION,      Cmd_MapLog_f,               CMD_COST_HEAVY },
+	{ "me",              CMD_MESSAGE | CMD_INTERMISSION,      Cmd_Me_f,                   CMD_COST_DEFAULT },
+	{ "me_team",         CMD_MESSAGE | CMD_INTERMISSION,      Cmd_Me_f,                   CMD_COST_DEFAULT },
+	{ "mt",              CMD_MESSAGE | CMD_INTERMISSION,      Cmd_PrivateMessage_f,       CMD_COST_MEDIUM },
+	{ "noclip",          CMD_CHEAT_TEAM,                      Cmd_Noclip_f,               CMD_COST_DEFAULT },
+	{ "notarget",        CMD_CHEAT | CMD_TEAM | CMD_ALIVE,    Cmd_Notarget_f,             CMD_COST_DEFAULT },
+	{ "print_momentum",  CMD_CHEAT,                           Cmd_PrintMomentum_f,        CMD_COST_DEFAULT },
+	{ "pubkey_identify", CMD_INTERMISSION,                    Cmd_Pubkey_Identify_f,      CMD_COST_DEFAULT },
+	{ "r",               CMD_MESSAGE | CMD_INTERMISSION,      Cmd_ReplyPrivateMessage_f,  CMD_COST_DEFAULT },
+	{ "reload",          CMD_HUMAN | CMD_ALIVE,               Cmd_Reload_f,               CMD_COST_DEFAULT },
+	{ "say",             CMD_MESSAGE | CMD_INTERMISSION,      Cmd_Say_f,                  CMD_COST_DEFAULT },
+	{ "say_area",        CMD_MESSAGE | CMD_TEAM | CMD_ALIVE,  Cmd_SayArea_f,              CMD_COST_DEFAULT },
+	{ "say_area_team",   CMD_MESSAGE | CMD_TEAM | CMD_ALIVE,  Cmd_SayAreaTeam_f,          CMD_COST_DEFAULT },
+	{ "say_team",        CMD_MESSAGE | CMD_INTERMISSION,      Cmd_Say_f,                  CMD_COST_DEFAULT },
+	{ "score",           CMD_INTERMISSION,                    ScoreboardMessage,          CMD_COST_MEDIUM },
+	{ "sell",            CMD_HUMAN | CMD_ALIVE,               Cmd_Sell_f,                 CMD_COST_DEFAULT },
+	{ "setviewpos",      CMD_CHEAT_TEAM,                      Cmd_SetViewpos_f,           CMD_COST_DEFAULT },
+	{ "tactic",          CMD_TEAM,                            Cmd_Tactic_f,               CMD_COST_DEFAULT },
+	{ "team",            0,                                   Cmd_Team_f,                 CMD_COST_DEFAULT },
+	{ "teamstatus",      CMD_TEAM,                            Cmd_TeamStatus_f,           CMD_COST_MEDIUM },
+	{ "teamvote",        CMD_TEAM | CMD_INTERMISSION,         Cmd_Vote_f,                 CMD_COST_DEFAULT },
+	{ "unignore",        0,                                   Cmd_Ignore_f,               CMD_COST_DEFAULT },
+	{ "vote",            CMD_INTERMISSION,                    Cmd_Vote_f,                 CMD_COST_DEFAULT },
+	{ "vsay",            CMD_MESSAGE | CMD_INTERMISSION,      Cmd_VSay_f,                 CMD_COST_MEDIUM },
+	{ "vsay_local",      CMD_MESSAGE | CMD_INTERMISSION,      Cmd_VSay_f,                 CMD_COST_MEDIUM },
+	{ "vsay_team",       CMD_MESSAGE | CMD_INTERMISSION,      Cmd_VSay_f,                 CMD_COST_MEDIUM },
+	{ "where",           0,                                   Cmd_Where_f,                CMD_COST_DEFAULT }
 };
 static const size_t numCmds = ARRAY_LEN( cmds );
 
+// admin commands and unknown commands are looked up in the admin command table
+#define CMD_COST_ADMIN CMD_COST_HEAVY
+
+struct commandStats_t
+{
+	int     count;
+	int     dropped;
+	int64_t totalUs;
+	int     maxUs;
+};
+
+// one entry per cmds[] entry, plus a last one for admin commands
+static commandStats_t cmdStats[ numCmds + 1 ];
+
+/*
+=================
+G_CommandRateLimited
+
+Charge a command to the client's token bucket. The bucket holds up to
+g_cmdBurst tokens and regains g_cmdRate tokens per second; commands are
+dropped while it does not hold enough tokens to pay for them.
+=================
+*/
+static bool G_CommandRateLimited( gentity_t *ent, int cost )
+{
+	clientPersistant_t *pers = &ent->client->pers;
+	float rate = g_cmdRate.Get();
+	float burst = std::max( g_cmdBurst.Get(), 1.0f );
+
+	if ( rate <= 0.0f || pers->localClient || ( ent->r.svFlags & SVF_BOT ) )
+	{
+		return false;
+	}
+
+	int time = level.time + level.pausedTime;
+
+	if ( !pers->cmdTokenTime || time < pers->cmdTokenTime )
+	{
+		pers->cmdTokens = burst;
+	}
+	else
+	{
+		pers->cmdTokens = std::min( burst, pers->cmdTokens + ( time - pers->cmdTokenTime ) * rate * 0.001f );
+	}
+
+	pers->cmdTokenTime = time;
+
+	// a command costing more than the whole bucket may still run with a full bucket
+	if ( pers->cmdTokens >= std::min( static_cast<float>( cost ), burst ) )
+	{
+		pers->cmdTokens -= cost;
+		return false;
+	}
+
+	pers->cmdDropped++;
+
+	if ( time - pers->cmdWarnTime >= 1000 )
+	{
+		pers->cmdWarnTime = time;
+		trap_SendServerCommand( ent->num(), va( "print_tr %s",
+		                        QQ( N_("You are sending commands too quickly, some were ignored") ) ) );
+	}
+
+	return true;
+}
+
+static void G_AccountCommand( gentity_t *ent, commandStats_t &stats, int us )
+{
+	stats.count++;
+	stats.totalUs += us;
+	stats.maxUs = std::max( stats.maxUs, us );
+
+	ent->client->pers.cmdCount++;
+	ent->client->pers.cmdTimeUs += us;
+}
+
+static int G_CommandMicroseconds( std::chrono::steady_clock::time_point start )
+{
+	return static_cast<int>( std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - start ).count() );
+}
+
 /*
 =================
 ClientCommand
@@ -4338,6 +4421,15 @@ void ClientCommand( int clientNum )
 	trap_Argv( 0, cmd, sizeof( cmd ) );
 
 	command = (commands_t*) bsearch( cmd, cmds, numCmds, sizeof( cmds[ 0 ] ), cmdcmp );
+	commandStats_t &stats = cmdStats[ command ? command - cmds : numCmds ];
+
+	if ( G_CommandRateLimited( ent, command ? command->cmdCost : CMD_COST_ADMIN ) )
+	{
+		stats.dropped++;
+		return;
+	}
+
+	auto start = std::chrono::steady_clock::now();
 
 	if ( !command )
 	{
@@ -4347,6 +4439,7 @@ void ClientCommand( int clientNum )
 			                        va( "print_tr %s %s", QQ( N_("Unknown command $1$") ), Quote( cmd ) ) );
 		}
 
+		G_AccountCommand( ent, stats, G_CommandMicroseconds( start ) );
 		return;
 	}
 
@@ -4413,8 +4506,68 @@ void ClientCommand( int clientNum )
 	}
 
 	command->cmdHandler( ent );
+
+	G_AccountCommand( ent, stats, G_CommandMicroseconds( start ) );
 }
 
+class CmdStatsCmd : public Cmd::StaticCmd
+{
+public:
+	CmdStatsCmd() : StaticCmd( "cmdstats", Cmd::SGAME_VM, "print client command counts and CPU time" ) {}
+	void Run( const Cmd::Args& args ) const override
+	{
+		if ( args.Argc() > 1 && args.Argv( 1 ) == "reset" )
+		{
+			for ( commandStats_t &stats : cmdStats )
+			{
+				stats = {};
+			}
+
+			for ( int i = 0; i < level.maxclients; i++ )
+			{
+				clientPersistant_t &pers = level.clients[ i ].pers;
+				pers.cmdCount = pers.cmdDropped = 0;
+				pers.cmdTimeUs = 0;
+			}
+
+			return;
+		}
+
+		Print( "%-16s %4s %8s %8s %10s %8s", "command", "cost", "count", "dropped", "total ms", "max ms" );
+
+		for ( size_t i = 0; i <= numCmds; i++ )
+		{
+			const commandStats_t &stats = cmdStats[ i ];
+
+			if ( !stats.count && !stats.dropped )
+			{
+				continue;
+			}
+
+			Print( "%-16s %4d %8d %8d %10.2f %8.2f", i < numCmds ? cmds[ i ].cmdName : "(admin)",
+			       i < numCmds ? cmds[ i ].cmdCost : CMD_COST_ADMIN, stats.count, stats.dropped,
+			       stats.totalUs * 0.001, stats.maxUs * 0.001 );
+		}
+
+		Print( "" );
+		Print( "%-3s %-32s %8s %8s %10s %7s", "num", "name", "count", "dropped", "total ms", "tokens" );
+
+		for ( int i = 0; i < level.maxclients; i++ )
+		{
+			const clientPersistant_t &pers = level.clients[ i ].pers;
+
+			if ( pers.connected == CON_DISCONNECTED )
+			{
+				continue;
+			}
+
+			Print( "%-3d %-32s %8d %8d %10.2f %7.1f", i, Color::StripColors( pers.netname ),
+			       pers.cmdCount, pers.cmdDropped, pers.cmdTimeUs * 0.001, pers.cmdTokens );
+		}
+	}
+};
+static CmdStatsCmd cmdStatsCmdRegistration;
+
 void G_UnEscapeString( const char *in, char *out, int len )
 {
 	len--;
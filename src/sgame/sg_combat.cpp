@@ -28,6 +28,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "sg_local.h"
 #include "Entities.h"
 #include "CBSE.h"
+#include "sg_cm_world.h"
 
 Cvar::Cvar<float> g_rewardDestruction( "g_rewardDestruction", "Reward players when they destroy a building by momentum * g_rewardDestruction", Cvar::NONE, 10.f );
 // damage region data
@@ -470,7 +471,7 @@ void G_RewardAttackers( gentity_t *self )
 			G_AddCreditToClient( player->client, static_cast<short>( reward * g_rewardDestruction.Get() ), true );
 
 			// Add momentum
-			G_AddMomentumForDestroyingStep( self, player, reward );
+			G_AddMomentumForDestroying( self, player, reward );
 
 			enemyDamagedBuildable = true;
 		}
@@ -483,13 +484,10 @@ void G_RewardAttackers( gentity_t *self )
 			G_AddCreditToClient( player->client, ( short )reward, true );
 
 			// Add momentum
-			G_AddMomentumForKillingStep( self, player, share );
+			G_AddMomentumForKilling( self, player, share );
 		}
 	}
 
-	// Complete momentum modification
-	G_AddMomentumEnd();
-
 	if ( enemyDamagedBuildable )
 	{
 		TransferBPToEnemyTeam( self );
@@ -962,6 +960,18 @@ void G_SelectiveDamage( gentity_t *targ, gentity_t * /*inflictor*/, gentity_t *a
  */
 bool G_CanDamage( gentity_t *targ, const vec3_t origin )
 {
+	// the midpoint of the bounds, then four offsets around it. this should
+	// probably check in the plane of projection, rather than in world
+	// coordinate, and also include Z
+	static const float offsets[][ 2 ] =
+	{
+		{   0.0f,   0.0f },
+		{  15.0f,  15.0f },
+		{  15.0f, -15.0f },
+		{ -15.0f,  15.0f },
+		{ -15.0f, -15.0f },
+	};
+
 	vec3_t  dest;
 	trace_t tr;
 	vec3_t  midpoint;
@@ -971,68 +981,185 @@ bool G_CanDamage( gentity_t *targ, const vec3_t origin )
 	VectorAdd( targ->r.absmin, targ->r.absmax, midpoint );
 	VectorScale( midpoint, 0.5, midpoint );
 
-	VectorCopy( midpoint, dest );
-	trap_Trace( &tr, origin, vec3_origin, vec3_origin, dest, ENTITYNUM_NONE, MASK_SOLID, 0 );
+	for ( unsigned i = 0; i < ARRAY_LEN( offsets ); i++ )
+	{
+		VectorCopy( midpoint, dest );
+		dest[ 0 ] += offsets[ i ][ 0 ];
+		dest[ 1 ] += offsets[ i ][ 1 ];
+		trap_Trace( &tr, origin, vec3_origin, vec3_origin, dest, ENTITYNUM_NONE, MASK_SOLID, 0 );
+
+		// only the direct trace may be stopped by the target itself
+		if ( tr.fraction == 1.0 || ( i == 0 && tr.entityNum == targ->num() ) )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+================================================================================
+
+Splash damage
+
+Explosions, fire spreading and chained sub-missiles often go off in the same
+spot several times within a frame. The line-of-effect of each (origin, target)
+pair is remembered until the end of the frame, with origins snapped to a small
+grid, so that these don't redo the same traces over and over. A result is dropped
+as soon as any entity is linked or unlinked, since a door or mover may have come
+between the origin and the target.
+
+================================================================================
+*/
+
+// All origins within one cell share the result of the first, so splash visibility is
+// only exact up to the cell size. 0 traces from every origin.
+static Cvar::Range<Cvar::Cvar<int>> g_splashVisibilityCellSize(
+	"g_splashVisibilityCellSize",
+	"grid size used to share splash damage line-of-effect results during a frame, origins within one cell share a result, 0 disables",
+	Cvar::NONE, 4, 0, 64 );
+
+namespace {
+struct SplashVisibilityKey
+{
+	int cell[ 3 ];
+	int target;
+
+	bool operator==( const SplashVisibilityKey &other ) const
+	{
+		return target == other.target && cell[ 0 ] == other.cell[ 0 ]
+		       && cell[ 1 ] == other.cell[ 1 ] && cell[ 2 ] == other.cell[ 2 ];
+	}
+};
 
-	if ( tr.fraction == 1.0  || tr.entityNum == targ->num() )
+struct SplashVisibilityHash
+{
+	size_t operator()( const SplashVisibilityKey &key ) const
 	{
-		return true;
+		size_t hash = std::hash<int>()( key.target );
+		for ( int i = 0; i < 3; i++ )
+		{
+			hash = hash * 31 + std::hash<int>()( key.cell[ i ] );
+		}
+		return hash;
 	}
+};
+
+struct SplashVisibility
+{
+	unsigned generation;
+	vec3_t   absmin, absmax;
+	int      worldChanges;
+	bool     visible;
+};
+
+std::unordered_map<SplashVisibilityKey, SplashVisibility, SplashVisibilityHash> splashVisibility;
+int splashVisibilityTime = -1;
+} // namespace
+
+/**
+ * @brief Same as G_CanDamage, but shares results between splashes happening
+ *        near each other during the same frame.
+ */
+static bool G_CanSplashDamage( gentity_t *targ, const vec3_t origin )
+{
+	int cellSize = g_splashVisibilityCellSize.Get();
 
-	// this should probably check in the plane of projection,
-	// rather than in world coordinate, and also include Z
-	VectorCopy( midpoint, dest );
-	dest[ 0 ] += 15.0;
-	dest[ 1 ] += 15.0;
-	trap_Trace( &tr, origin, vec3_origin, vec3_origin, dest, ENTITYNUM_NONE, MASK_SOLID, 0 );
+	if ( cellSize <= 0 )
+	{
+		return G_CanDamage( targ, origin );
+	}
 
-	if ( tr.fraction == 1.0 )
+	if ( splashVisibilityTime != level.time )
 	{
-		return true;
+		splashVisibility.clear();
+		splashVisibilityTime = level.time;
 	}
 
-	VectorCopy( midpoint, dest );
-	dest[ 0 ] += 15.0;
-	dest[ 1 ] -= 15.0;
-	trap_Trace( &tr, origin, vec3_origin, vec3_origin, dest, ENTITYNUM_NONE, MASK_SOLID, 0 );
+	SplashVisibilityKey key;
+	key.target = targ->num();
 
-	if ( tr.fraction == 1.0 )
+	for ( int i = 0; i < 3; i++ )
 	{
-		return true;
+		key.cell[ i ] = static_cast<int>( floorf( origin[ i ] / cellSize ) );
 	}
 
-	VectorCopy( midpoint, dest );
-	dest[ 0 ] -= 15.0;
-	dest[ 1 ] += 15.0;
-	trap_Trace( &tr, origin, vec3_origin, vec3_origin, dest, ENTITYNUM_NONE, MASK_SOLID, 0 );
+	auto it = splashVisibility.find( key );
 
-	if ( tr.fraction == 1.0 )
+	// the target or whatever stands in the way may have moved or been replaced since
+	// the result was stored
+	if ( it != splashVisibility.end() && it->second.generation == targ->generation
+	     && it->second.worldChanges == G_CM_WorldChanges()
+	     && VectorCompare( it->second.absmin, targ->r.absmin )
+	     && VectorCompare( it->second.absmax, targ->r.absmax ) )
 	{
-		return true;
+		return it->second.visible;
 	}
 
-	VectorCopy( midpoint, dest );
-	dest[ 0 ] -= 15.0;
-	dest[ 1 ] -= 15.0;
-	trap_Trace( &tr, origin, vec3_origin, vec3_origin, dest, ENTITYNUM_NONE, MASK_SOLID, 0 );
+	SplashVisibility &result = splashVisibility[ key ];
+	result.generation = targ->generation;
+	VectorCopy( targ->r.absmin, result.absmin );
+	VectorCopy( targ->r.absmax, result.absmax );
+	result.worldChanges = G_CM_WorldChanges();
+	result.visible = G_CanDamage( targ, origin );
+
+	return result.visible;
+}
+
+/**
+ * @brief Lists the entities whose bounds intersect a sphere.
+ * @param[out] entityList
+ * @param[out] distances distance from the origin to each entity's bounds
+ * @return the number of listed entities
+ */
+static int G_SplashTargets( const vec3_t origin, float radius, gentity_t *ignore,
+                            int *entityList, float *distances )
+{
+	vec3_t mins, maxs;
 
-	if ( tr.fraction == 1.0 )
+	for ( int i = 0; i < 3; i++ )
 	{
-		return true;
+		mins[ i ] = origin[ i ] - radius;
+		maxs[ i ] = origin[ i ] + radius;
 	}
 
-	return false;
+	int numListedEntities = trap_EntitiesInBox( mins, maxs, entityList, MAX_GENTITIES );
+	int numTargets = 0;
+
+	for ( int e = 0; e < numListedEntities; e++ )
+	{
+		gentity_t *ent = &g_entities[ entityList[ e ] ];
+
+		if ( ent == ignore )
+		{
+			continue;
+		}
+
+		// find the distance from the edge of the bounding box
+		float dist = G_DistanceToBBox( VEC2GLM( origin ), ent );
+
+		if ( dist >= radius )
+		{
+			continue;
+		}
+
+		entityList[ numTargets ] = entityList[ e ];
+		distances[ numTargets ] = dist;
+		numTargets++;
+	}
+
+	return numTargets;
 }
 
 bool G_SelectiveRadiusDamage( const vec3_t origin, gentity_t *attacker, float damage,
                                   float radius, gentity_t *ignore, int mod, int ignoreTeam )
 {
-	float     points, dist;
+	float     points;
 	gentity_t *ent;
 	int       entityList[ MAX_GENTITIES ];
-	int       numListedEntities;
-	vec3_t    mins, maxs;
-	int       i, e;
+	float     distances[ MAX_GENTITIES ];
+	int       numTargets;
 	bool  hitClient = false;
 
 	if ( radius < 1 )
@@ -1040,40 +1167,26 @@ bool G_SelectiveRadiusDamage( const vec3_t origin, gentity_t *attacker, float da
 		radius = 1;
 	}
 
-	for ( i = 0; i < 3; i++ )
-	{
-		mins[ i ] = origin[ i ] - radius;
-		maxs[ i ] = origin[ i ] + radius;
-	}
-
-	numListedEntities = trap_EntitiesInBox( mins, maxs, entityList, MAX_GENTITIES );
+	numTargets = G_SplashTargets( origin, radius, ignore, entityList, distances );
 
-	for ( e = 0; e < numListedEntities; e++ )
+	for ( int e = 0; e < numTargets; e++ )
 	{
 		ent = &g_entities[ entityList[ e ] ];
 
-		if ( ent == ignore )
-		{
-			continue;
-		}
-
 		if ( ent->flags & FL_NOTARGET )
 		{
 			continue;
 		}
 
-		// find the distance from the edge of the bounding box
-		dist = G_DistanceToBBox( VEC2GLM( origin ), ent );
-
-		if ( dist >= radius )
+		// do the cheap checks before tracing
+		if ( !ent->client || ent->client->pers.team == ignoreTeam )
 		{
 			continue;
 		}
 
-		points = damage * ( 1.0 - dist / radius );
+		points = damage * ( 1.0 - distances[ e ] / radius );
 
-		if ( G_CanDamage( ent, origin ) && ent->client &&
-		     ent->client->pers.team != ignoreTeam )
+		if ( G_CanSplashDamage( ent, origin ) )
 		{
 			hitClient = ent->Damage(points, attacker, VEC2GLM( origin ), Util::nullopt,
 			                                DAMAGE_NO_LOCDAMAGE, (meansOfDeath_t)mod);
@@ -1086,13 +1199,12 @@ bool G_SelectiveRadiusDamage( const vec3_t origin, gentity_t *attacker, float da
 bool G_RadiusDamage( const vec3_t origin, gentity_t *attacker, float damage,
                          float radius, gentity_t *ignore, int dflags, int mod, team_t testHit )
 {
-	float     points, dist;
+	float     points;
 	gentity_t *ent;
 	int       entityList[ MAX_GENTITIES ];
-	int       numListedEntities;
-	vec3_t    mins, maxs;
+	float     distances[ MAX_GENTITIES ];
+	int       numTargets;
 	vec3_t    dir;
-	int       i, e;
 	bool  hitSomething = false;
 
 	if ( radius < 1 )
@@ -1100,51 +1212,37 @@ bool G_RadiusDamage( const vec3_t origin, gentity_t *attacker, float damage,
 		radius = 1;
 	}
 
-	for ( i = 0; i < 3; i++ )
-	{
-		mins[ i ] = origin[ i ] - radius;
-		maxs[ i ] = origin[ i ] + radius;
-	}
-
-	numListedEntities = trap_EntitiesInBox( mins, maxs, entityList, MAX_GENTITIES );
+	numTargets = G_SplashTargets( origin, radius, ignore, entityList, distances );
 
-	for ( e = 0; e < numListedEntities; e++ )
+	for ( int e = 0; e < numTargets; e++ )
 	{
 		ent = &g_entities[ entityList[ e ] ];
 
-		if ( ent == ignore )
+		if ( testHit != TEAM_NONE && ( G_Team( ent ) != testHit || !Entities::IsAlive( ent ) ) )
 		{
 			continue;
 		}
 
-		// find the distance from the edge of the bounding box
-		dist = G_DistanceToBBox( VEC2GLM( origin ), ent );
-
-		if ( dist >= radius )
+		if ( !G_CanSplashDamage( ent, origin ) )
 		{
 			continue;
 		}
 
-		points = damage * ( 1.0 - dist / radius );
-
-		if ( G_CanDamage( ent, origin ) )
+		if ( testHit != TEAM_NONE )
 		{
-			if ( testHit == TEAM_NONE )
-			{
-				VectorSubtract( ent->r.currentOrigin, origin, dir );
-				// push the center of mass higher than the origin so players
-				// get knocked into the air more
-				dir[ 2 ] += 24;
-				VectorNormalize( dir );
-
-				hitSomething = ent->Damage(points, attacker, VEC2GLM( origin ), VEC2GLM( dir ),
-				                                   (DAMAGE_NO_LOCDAMAGE | dflags), (meansOfDeath_t)mod);
-			}
-			else if ( G_Team( ent ) == testHit && Entities::IsAlive( ent ) )
-			{
-				return true;
-			}
+			return true;
 		}
+
+		points = damage * ( 1.0 - distances[ e ] / radius );
+
+		VectorSubtract( ent->r.currentOrigin, origin, dir );
+		// push the center of mass higher than the origin so players
+		// get knocked into the air more
+		dir[ 2 ] += 24;
+		VectorNormalize( dir );
+
+		hitSomething = ent->Damage(points, attacker, VEC2GLM( origin ), VEC2GLM( dir ),
+		                                   (DAMAGE_NO_LOCDAMAGE | dflags), (meansOfDeath_t)mod);
 	}
 
 	return hitSomething;
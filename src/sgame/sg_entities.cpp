@@ -35,9 +35,13 @@ Maryland 20850 USA.
 #include "common/Common.h"
 #include "sg_local.h"
 #include "sg_entities.h"
+#include "sg_cm_world.h"
 #include "sg_spawn.h"
 #include "CBSE.h"
 
+#include <deque>
+#include <set>
+#include <unordered_set>
 #include <glm/geometric.hpp>
 #include <glm/gtx/norm.hpp>
 
@@ -64,7 +68,7 @@ void G_InitGentity( gentity_t *entity )
 	++entity->generation;
 	entity->inuse = true;
 	entity->enabled = true;
-	entity->classname = BG_strdup( "noclass" );
+	G_SetClassname( entity, "noclass" );
 	entity->s.number = entity->num();
 	entity->r.ownerNum = ENTITYNUM_NONE;
 	entity->creationTime = level.time;
@@ -75,6 +79,57 @@ void G_InitGentity( gentity_t *entity )
 	}
 }
 
+/*
+=================
+Entity slots
+
+Freed slots are queued in the order they were freed, so the front of the queue
+is always the slot that was freed the longest time ago. A queued slot may have
+been reused and freed again in the meantime, which is detected by comparing its
+freetime to the one it was queued with.
+=================
+*/
+
+namespace {
+struct freeEntitySlot_t
+{
+	int num;
+	int freetime;
+};
+
+std::deque<freeEntitySlot_t> freeEntitySlots;
+
+struct
+{
+	int allocated;     // calls to G_NewEntity
+	int freed;         // non-client entities freed
+	int reused;        // allocations served from the free queue
+	int forced;        // allocations that had to reuse a recently freed slot
+	int inUse;         // non-client entities currently in use
+	int highWaterMark; // maximum of inUse
+} entitySlotStats;
+}
+
+void G_ResetEntitySlots()
+{
+	freeEntitySlots.clear();
+	entitySlotStats = {};
+}
+
+static bool EntitySlotQueued( const freeEntitySlot_t &slot )
+{
+	const gentity_t *entity = &g_entities[ slot.num ];
+
+	return !entity->inuse && entity->freetime == slot.freetime;
+}
+
+static bool EntitySlotRecentlyFreed( const freeEntitySlot_t &slot )
+{
+	// the first couple seconds of server time can involve a lot of
+	// freeing and allocating, so relax the replacement policy
+	return slot.freetime > level.startTime + 2000 && level.time - slot.freetime < 1000;
+}
+
 /*
 =================
 FindEntitySlot
@@ -92,38 +147,30 @@ angles and bad trails.
 */
 static gentity_t *FindEntitySlot()
 {
-	// we iterate through all the entities and look for a free one that was allocated enough time ago,
-	// as well as one that died recently in case the first kind is not available
-	gentity_t *newEntity = &g_entities[ MAX_CLIENTS ];
-	gentity_t *forcedEnt = nullptr;
-	int i;
-
-	for ( i = MAX_CLIENTS; i < level.num_entities; i++, newEntity++ )
+	// drop slots that were reused since they were queued
+	while ( !freeEntitySlots.empty() && !EntitySlotQueued( freeEntitySlots.front() ) )
 	{
-		if ( newEntity->inuse )
-		{
-			continue;
-		}
-
-		// the first couple seconds of server time can involve a lot of
-		// freeing and allocating, so relax the replacement policy
-		if ( newEntity->freetime > level.startTime + 2000 && level.time - newEntity->freetime < 1000 )
-		{
-			if( ! forcedEnt || newEntity->freetime < forcedEnt->freetime ) {
-				forcedEnt = newEntity;
-			}
-			continue;
-		}
+		freeEntitySlots.pop_front();
+	}
 
-		// reuse this slot
+	// reuse the slot that was freed the longest time ago, if it was freed long enough ago
+	if ( !freeEntitySlots.empty() && !EntitySlotRecentlyFreed( freeEntitySlots.front() ) )
+	{
+		gentity_t *newEntity = &g_entities[ freeEntitySlots.front().num ];
+		freeEntitySlots.pop_front();
+		entitySlotStats.reused++;
 		return newEntity;
 	}
 
-	if ( i == ENTITYNUM_MAX_NORMAL )
+	if ( level.num_entities == ENTITYNUM_MAX_NORMAL )
 	{
 		// no more entities available! let's force-reuse one if possible, or die
-		if ( forcedEnt )
+		if ( !freeEntitySlots.empty() )
 		{
+			gentity_t *forcedEnt = &g_entities[ freeEntitySlots.front().num ];
+			freeEntitySlots.pop_front();
+			entitySlotStats.forced++;
+
 			if ( g_debugEntities.Get() ) {
 				Log::Verbose( "Reusing Entity %i, freed at %i (%ims ago)",
 				              forcedEnt->num(), forcedEnt->freetime, level.time - forcedEnt->freetime );
@@ -132,7 +179,7 @@ static gentity_t *FindEntitySlot()
 			return forcedEnt;
 		}
 
-		for ( i = 0; i < MAX_GENTITIES; i++ )
+		for ( int i = 0; i < MAX_GENTITIES; i++ )
 		{
 			Log::Warn( "%4i: %s", i, g_entities[ i ].classname );
 		}
@@ -141,6 +188,7 @@ static gentity_t *FindEntitySlot()
 	}
 
 	// open up a new slot
+	gentity_t *newEntity = &g_entities[ level.num_entities ];
 	level.num_entities++;
 
 	// let the server system know that there are more entities
@@ -153,6 +201,11 @@ static gentity_t *FindEntitySlot()
 gentity_t *G_NewEntity( initEntityStyle_t style )
 {
 	gentity_t *ent = FindEntitySlot();
+
+	entitySlotStats.allocated++;
+	entitySlotStats.inUse++;
+	entitySlotStats.highWaterMark = std::max( entitySlotStats.highWaterMark, entitySlotStats.inUse );
+
 	G_InitGentity( ent );
 	if ( style == NO_CBSE )
 	{
@@ -178,6 +231,7 @@ void G_FreeEntity( gentity_t *entity )
 	}
 
 	G_BotRemoveObstacle( entity->num() );
+	G_ForgetSupport( entity );
 
 	if ( entity->s.eType == entityType_t::ET_BEACON && entity->s.modelindex == BCT_TAG )
 	{
@@ -194,25 +248,24 @@ void G_FreeEntity( gentity_t *entity )
 
 	unsigned generation = entity->generation;
 
-	for ( const fieldDescriptor_t* field = fields; field < fields + fieldsSize; field++ ) {
-		if ( field->type == F_STRING ) {
-			char* &string = *( char** ) ( ( byte* ) entity + field->offset );
-
-			if ( string ) {
-				BG_Free( string );
-				string = nullptr;
-			}
-		}
-	}
+	// string fields are interned, see G_InternString, so there is nothing to free
 
 	entity->~gentity_t();
 	new(entity) gentity_t{};
 
 	entity->generation = generation + 1;
 	entity->entity = nullptr;
-	entity->classname = BG_strdup( "freent" );
+	G_SetClassname( entity, "freent" );
 	entity->freetime = level.time;
 	entity->inuse = false;
+
+	// client slots are never handed out by FindEntitySlot
+	if ( entity->num() >= MAX_CLIENTS )
+	{
+		freeEntitySlots.push_back( { entity->num(), entity->freetime } );
+		entitySlotStats.freed++;
+		entitySlotStats.inUse--;
+	}
 }
 
 
@@ -232,7 +285,7 @@ gentity_t *G_NewTempEntity( glm::vec3 origin, int event )
 	newEntity = G_NewEntity( NO_CBSE );
 	newEntity->s.eType = Util::enum_cast<entityType_t>( Util::ordinal(entityType_t::ET_EVENTS) + event );
 
-	newEntity->classname = BG_strdup( "tempEntity" );
+	G_SetClassname( newEntity, "tempEntity" );
 	newEntity->eventTime = level.time;
 	newEntity->freeAfterEvent = true;
 
@@ -253,11 +306,59 @@ gentity debugging
 =================================================================================
 */
 
-static bool matchesName( mapEntity_t const& ent, std::string const& name )
+class EntitySlotsCmd : public Cmd::StaticCmd
+{
+public:
+	EntitySlotsCmd() : StaticCmd( "entitySlots", Cmd::SGAME_VM, "print entity slot allocation statistics" ) {}
+	void Run( const Cmd::Args& ) const override
+	{
+		int recent = 0;
+
+		for ( const freeEntitySlot_t &slot : freeEntitySlots )
+		{
+			if ( EntitySlotQueued( slot ) && EntitySlotRecentlyFreed( slot ) )
+			{
+				recent++;
+			}
+		}
+
+		Print( "slots:     %d of %d used, high-water mark %d", entitySlotStats.inUse,
+		       ENTITYNUM_MAX_NORMAL - MAX_CLIENTS, entitySlotStats.highWaterMark );
+		Print( "allocated: %d (%d reused, %d forced reuses)", entitySlotStats.allocated,
+		       entitySlotStats.reused, entitySlotStats.forced );
+		Print( "freed:     %d (%d queued, %d freed less than a second ago)", entitySlotStats.freed,
+		       static_cast<int>( freeEntitySlots.size() ), recent );
+		Print( "opened:    %d", level.num_entities - MAX_CLIENTS );
+	}
+};
+static EntitySlotsCmd entitySlotsCmdRegistration;
+
+class EntityPoolsCmd : public Cmd::StaticCmd
+{
+public:
+	EntityPoolsCmd() : StaticCmd( "entityPools", Cmd::SGAME_VM, "print CBSE entity pool allocation statistics" ) {}
+	void Run( const Cmd::Args& ) const override
+	{
+		Print( "%-24s %6s %6s %6s %6s %8s %8s %5s", "type", "size", "chunks", "live", "peak",
+		       "allocs", "recycled", "heap" );
+
+		for ( const EntityPoolStats &stats : GetEntityPoolStats() )
+		{
+			Print( "%-24s %6d %6d %6d %6d %8d %8d %5d", stats.name,
+			       static_cast<int>( stats.objectSize ), static_cast<int>( stats.chunks ),
+			       static_cast<int>( stats.live ), static_cast<int>( stats.peak ),
+			       static_cast<int>( stats.allocations ), static_cast<int>( stats.recycled ),
+			       static_cast<int>( stats.overflows ) );
+		}
+	}
+};
+static EntityPoolsCmd entityPoolsCmdRegistration;
+
+static bool matchesName( mapEntity_t const& ent, char const* name )
 {
 	for ( char const* n : ent.names )
 	{
-		if ( n && !Q_stricmp( name.c_str(), n ) )
+		if ( n && ( n == name || !Q_stricmp( name, n ) ) )
 		{
 			return true;
 		}
@@ -265,6 +366,273 @@ static bool matchesName( mapEntity_t const& ent, std::string const& name )
 	return false;
 }
 
+/*
+=================================================================================
+
+interned strings
+
+The string fields of entities point into a table of interned strings, so that
+equal strings share their storage and equal pointers mean equal strings. The
+table is only emptied when a new game is initialized, so the strings must never
+be freed or written to.
+
+=================================================================================
+*/
+
+static std::unordered_set<std::string> internedStrings;
+
+char *G_InternString( const char *string )
+{
+	auto it = internedStrings.insert( string ).first;
+	return const_cast<char *>( it->c_str() );
+}
+
+void G_ResetInternedStrings()
+{
+	internedStrings.clear();
+}
+
+/*
+=================================================================================
+
+classname and name index
+
+Maps every classname and name alias to the numbers of the entities that carry
+it, so that target chains and classname searches only visit matching entities.
+The index has to be told whenever one of these fields changes, see
+G_SetClassname and G_UpdateEntityIndex.
+
+=================================================================================
+*/
+
+static Cvar::Cvar<bool> g_debugEntityIndex(
+	"g_debugEntityIndex",
+	"cross-check entity name and classname lookups against a full scan",
+	Cvar::NONE, false );
+
+using entityIndex_t = std::unordered_map<std::string, std::set<int>, Str::IHash, Str::IEqual>;
+
+struct indexedEntity_t
+{
+	std::string classname;
+	std::vector<std::string> names;
+};
+
+static entityIndex_t entitiesByClassname;
+static entityIndex_t entitiesByName;
+static indexedEntity_t indexedEntities[ MAX_GENTITIES ];
+
+// linked trigger entities in world sector order, collected again by G_TriggersInBox
+// whenever a trigger has been linked or unlinked
+static std::vector<int> triggerEntities;
+static int triggerEntitiesChanges = -1;
+
+static void EntityIndexRemove( entityIndex_t &index, const std::string &key, int num )
+{
+	auto it = index.find( key );
+
+	if ( it != index.end() )
+	{
+		it->second.erase( num );
+
+		if ( it->second.empty() )
+		{
+			index.erase( it );
+		}
+	}
+}
+
+void G_ResetEntityIndex()
+{
+	entitiesByClassname.clear();
+	entitiesByName.clear();
+
+	for ( indexedEntity_t &indexed : indexedEntities )
+	{
+		indexed.classname.clear();
+		indexed.names.clear();
+	}
+
+	triggerEntities.clear();
+	triggerEntitiesTime = -1;
+}
+
+/*
+=================
+G_UpdateEntityIndex
+
+Reindexes an entity under its current classname and names
+=================
+*/
+void G_UpdateEntityIndex( gentity_t *entity )
+{
+	int num = entity->num();
+	indexedEntity_t &indexed = indexedEntities[ num ];
+
+	if ( !indexed.classname.empty() )
+	{
+		EntityIndexRemove( entitiesByClassname, indexed.classname, num );
+		indexed.classname.clear();
+	}
+
+	for ( const std::string &name : indexed.names )
+	{
+		EntityIndexRemove( entitiesByName, name, num );
+	}
+	indexed.names.clear();
+
+	if ( entity->classname && entity->classname[ 0 ] )
+	{
+		indexed.classname = entity->classname;
+		entitiesByClassname[ indexed.classname ].insert( num );
+	}
+
+	for ( char const* name : entity->mapEntity.names )
+	{
+		if ( name && name[ 0 ] )
+		{
+			indexed.names.emplace_back( name );
+			entitiesByName[ indexed.names.back() ].insert( num );
+		}
+	}
+}
+
+/*
+=================
+G_SetClassname
+
+Replaces the classname of an entity and keeps the index up to date
+=================
+*/
+void G_SetClassname( gentity_t *entity, const char *classname )
+{
+	entity->classname = G_InternString( classname );
+	G_UpdateEntityIndex( entity );
+}
+
+// returns the first indexed entity after the given entity number
+static gentity_t *G_NextIndexedEntity( const entityIndex_t &index, const char *key, int after, bool skipdisabled,
+                                       size_t fieldofs, const char *match )
+{
+	auto it = index.find( key );
+
+	if ( it == index.end() )
+	{
+		return nullptr;
+	}
+
+	for ( auto num = it->second.upper_bound( after ); num != it->second.end(); ++num )
+	{
+		gentity_t *entity = &g_entities[ *num ];
+
+		if ( *num >= level.num_entities )
+			break;
+
+		if ( !entity->inuse )
+			continue;
+
+		if ( skipdisabled && !entity->enabled )
+			continue;
+
+		if ( fieldofs && match )
+		{
+			char *fieldString = * ( char ** )( ( byte * ) entity + fieldofs );
+			if ( fieldString != match && Q_stricmp( fieldString, match ) )
+				continue;
+		}
+
+		return entity;
+	}
+
+	return nullptr;
+}
+
+static gentity_t *G_NextNamedEntityLinear( const char *name, int after, bool skipdisabled )
+{
+	for ( gentity_t *entity = &g_entities[ after + 1 ]; entity < &g_entities[ level.num_entities ]; entity++ )
+	{
+		if ( !entity->inuse )
+			continue;
+
+		if ( skipdisabled && !entity->enabled )
+			continue;
+
+		if ( matchesName( entity->mapEntity, name ) )
+			return entity;
+	}
+
+	return nullptr;
+}
+
+// returns the first entity after the given entity number that goes by this name
+static gentity_t *G_NextNamedEntity( const char *name, int after, bool skipdisabled )
+{
+	gentity_t *entity = G_NextIndexedEntity( entitiesByName, name, after, skipdisabled, 0, nullptr );
+
+	if ( g_debugEntityIndex.Get() )
+	{
+		gentity_t *expected = G_NextNamedEntityLinear( name, after, skipdisabled );
+
+		if ( entity != expected )
+		{
+			Log::Warn( "entity name index is out of sync for \"%s\": found %s instead of %s",
+			           name, etos( entity ), etos( expected ) );
+		}
+
+		return expected;
+	}
+
+	return entity;
+}
+
+/*
+=================
+G_TriggersInBox
+
+Like trap_EntitiesInBox, but only returns linked trigger entities, in the
+same order. A map has few triggers, so they are collected whenever one is
+linked or unlinked and every toucher tests its bounds against that short list
+instead of querying the world sectors.
+=================
+*/
+int G_TriggersInBox( const vec3_t mins, const vec3_t maxs, int *list, int maxcount )
+{
+	if ( triggerEntitiesChanges != G_CM_TriggerChanges() )
+	{
+		triggerEntities.resize( MAX_GENTITIES );
+		triggerEntities.resize( G_CM_LinkedTriggers( triggerEntities.data(), MAX_GENTITIES ) );
+		triggerEntitiesChanges = G_CM_TriggerChanges();
+	}
+
+	int count = 0;
+
+	for ( int num : triggerEntities )
+	{
+		const gentity_t *entity = &g_entities[ num ];
+
+		// the entity may have changed since the list was built
+		if ( !entity->r.linked || !( entity->r.contents & CONTENTS_TRIGGER ) )
+		{
+			continue;
+		}
+
+		if ( entity->r.absmin[ 0 ] > maxs[ 0 ] || entity->r.absmin[ 1 ] > maxs[ 1 ] || entity->r.absmin[ 2 ] > maxs[ 2 ] ||
+		     entity->r.absmax[ 0 ] < mins[ 0 ] || entity->r.absmax[ 1 ] < mins[ 1 ] || entity->r.absmax[ 2 ] < mins[ 2 ] )
+		{
+			continue;
+		}
+
+		if ( count == maxcount )
+		{
+			break;
+		}
+
+		list[ count++ ] = num;
+	}
+
+	return count;
+}
+
 std::string etos( const gentity_t *entity )
 {
 	if ( !entity ) {
@@ -310,22 +678,10 @@ or nullptr if there are no further matching gentities.
 Set nullptr as previous gentity to start the iteration from the beginning
 =============
 */
-gentity_t *G_IterateEntities( gentity_t *entity, const char *classname, bool skipdisabled, size_t fieldofs, const char *match )
+static gentity_t *G_IterateEntitiesLinear( gentity_t *entity, const char *classname, bool skipdisabled, size_t fieldofs, const char *match )
 {
 	char *fieldString;
 
-	if ( !entity )
-	{
-		entity = g_entities;
-		//start after the reserved player slots, if we are not searching for a player
-		if ( classname && !strcmp(classname, S_PLAYER_CLASSNAME) )
-			entity += MAX_CLIENTS;
-	}
-	else
-	{
-		entity++;
-	}
-
 	for ( ; entity < &g_entities[ level.num_entities ]; entity++ )
 	{
 		if ( !entity->inuse )
@@ -335,13 +691,13 @@ gentity_t *G_IterateEntities( gentity_t *entity, const char *classname, bool ski
 			continue;
 
 
-		if ( classname && Q_stricmp( entity->classname, classname ) )
+		if ( classname && entity->classname != classname && Q_stricmp( entity->classname, classname ) )
 			continue;
 
 		if ( fieldofs && match )
 		{
 			fieldString = * ( char ** )( ( byte * ) entity + fieldofs );
-			if ( Q_stricmp( fieldString, match ) )
+			if ( fieldString != match && Q_stricmp( fieldString, match ) )
 				continue;
 		}
 
@@ -351,6 +707,44 @@ gentity_t *G_IterateEntities( gentity_t *entity, const char *classname, bool ski
 	return nullptr;
 }
 
+gentity_t *G_IterateEntities( gentity_t *entity, const char *classname, bool skipdisabled, size_t fieldofs, const char *match )
+{
+	if ( !entity )
+	{
+		entity = g_entities;
+		//start after the reserved player slots, if we are not searching for a player
+		if ( classname && !strcmp(classname, S_PLAYER_CLASSNAME) )
+			entity += MAX_CLIENTS;
+	}
+	else
+	{
+		entity++;
+	}
+
+	if ( !classname )
+	{
+		return G_IterateEntitiesLinear( entity, classname, skipdisabled, fieldofs, match );
+	}
+
+	int after = static_cast<int>( entity - g_entities ) - 1;
+	gentity_t *found = G_NextIndexedEntity( entitiesByClassname, classname, after, skipdisabled, fieldofs, match );
+
+	if ( g_debugEntityIndex.Get() )
+	{
+		gentity_t *expected = G_IterateEntitiesLinear( entity, classname, skipdisabled, fieldofs, match );
+
+		if ( found != expected )
+		{
+			Log::Warn( "entity classname index is out of sync for \"%s\": found %s instead of %s",
+			           classname, etos( found ), etos( expected ) );
+		}
+
+		return expected;
+	}
+
+	return found;
+}
+
 gentity_t *G_IterateEntities( gentity_t *entity )
 {
 	return G_IterateEntities( entity, nullptr, true, 0, nullptr );
@@ -622,13 +1016,15 @@ gentity_t *G_ResolveEntityKeyword( gentity_t *self, char *keyword )
 gentity_t *G_IterateTargets(gentity_t *entity, int *targetIndex, gentity_t *self)
 {
 	gentity_t *possibleTarget = nullptr;
+	bool resume = entity != nullptr;
+	int after = resume ? entity->num() : MAX_CLIENTS - 1;
 
-	if (entity)
-		goto cont;
+	if (!resume)
+		*targetIndex = 0;
 
-	for (*targetIndex = 0; self->mapEntity.targets[*targetIndex]; ++(*targetIndex))
+	for (; self->mapEntity.targets[*targetIndex]; ++(*targetIndex), resume = false, after = MAX_CLIENTS - 1)
 	{
-		if(self->mapEntity.targets[*targetIndex][0] == '$')
+		if(!resume && self->mapEntity.targets[*targetIndex][0] == '$')
 		{
 			possibleTarget = G_ResolveEntityKeyword( self, self->mapEntity.targets[*targetIndex] );
 			if(possibleTarget && possibleTarget->enabled)
@@ -636,44 +1032,30 @@ gentity_t *G_IterateTargets(gentity_t *entity, int *targetIndex, gentity_t *self
 			return nullptr;
 		}
 
-		for( entity = &g_entities[ MAX_CLIENTS ]; entity < &g_entities[ level.num_entities ]; entity++ )
-		{
-			if ( !entity->inuse || !entity->enabled)
-				continue;
-
-			if ( matchesName( entity->mapEntity, self->mapEntity.targets[*targetIndex] ) )
-			{
-				return entity;
-			}
-
-			cont: ;
-		}
+		possibleTarget = G_NextNamedEntity( self->mapEntity.targets[*targetIndex], after, true );
+		if ( possibleTarget )
+			return possibleTarget;
 	}
 	return nullptr;
 }
 
 gentity_t *G_IterateCallEndpoints(gentity_t *entity, int *calltargetIndex, gentity_t *self)
 {
-	if (entity)
-		goto cont;
+	gentity_t *possibleTarget;
+	bool resume = entity != nullptr;
+	int after = resume ? entity->num() : MAX_CLIENTS - 1;
 
-	for (*calltargetIndex = 0; self->mapEntity.calltargets[*calltargetIndex].name; ++(*calltargetIndex))
+	if (!resume)
+		*calltargetIndex = 0;
+
+	for (; self->mapEntity.calltargets[*calltargetIndex].name; ++(*calltargetIndex), resume = false, after = MAX_CLIENTS - 1)
 	{
-		if(self->mapEntity.calltargets[*calltargetIndex].name[0] == '$')
+		if(!resume && self->mapEntity.calltargets[*calltargetIndex].name[0] == '$')
 			return G_ResolveEntityKeyword( self, self->mapEntity.calltargets[*calltargetIndex].name );
 
-		for( entity = &g_entities[ MAX_CLIENTS ]; entity < &g_entities[ level.num_entities ]; entity++ )
-		{
-			if ( !entity->inuse )
-				continue;
-
-			if ( matchesName( entity->mapEntity, self->mapEntity.calltargets[*calltargetIndex].name ) )
-			{
-				return entity;
-			}
-
-			cont: ;
-		}
+		possibleTarget = G_NextNamedEntity( self->mapEntity.calltargets[*calltargetIndex].name, after, false );
+		if ( possibleTarget )
+			return possibleTarget;
 	}
 	return nullptr;
 }
@@ -133,6 +133,12 @@ struct gentityCall_t
 //lifecycle
 void       G_InitGentityMinimal( gentity_t *e );
 void       G_InitGentity( gentity_t *e );
+void       G_ResetEntitySlots();
+void       G_ResetEntityIndex();
+void       G_UpdateEntityIndex( gentity_t *entity );
+void       G_SetClassname( gentity_t *entity, const char *classname );
+char       *G_InternString( const char *string );
+void       G_ResetInternedStrings();
 gentity_t  *G_NewEntity( initEntityStyle_t style );
 gentity_t  *G_NewTempEntity( glm::vec3 origin, int event );
 void       G_FreeEntity( gentity_t *e );
@@ -147,6 +153,7 @@ gentity_t  *G_IterateEntities( gentity_t *entity );
 gentity_t  *G_IterateEntitiesOfClass( gentity_t *entity, const char *classname );
 gentity_t  *G_IterateEntitiesWithField( gentity_t *entity, size_t fieldofs, const char *match );
 gentity_t  *G_IterateEntitiesWithinRadius( gentity_t *entity, const glm::vec3& origin, float radius );
+int        G_TriggersInBox( const vec3_t mins, const vec3_t maxs, int *list, int maxcount );
 gentity_t  *G_PickRandomEntity( const char *classname, size_t fieldofs, const char *match );
 gentity_t  *G_PickRandomEntityOfClass( const char *classname );
 gentity_t  *G_PickRandomEntityWithField( size_t fieldofs, const char *match );
@@ -181,6 +188,7 @@ void       G_SetOrigin( gentity_t *ent, const glm::vec3& origin );
 //
 // g_spawn.c
 //
+void     G_ParseEntitiesFromString();
 void     G_SpawnEntitiesFromString();
 void     G_SpawnFakeEntities();
 
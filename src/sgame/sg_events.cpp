@@ -0,0 +1,75 @@
+/*
+===========================================================================
+
+Unvanquished GPL Source Code
+Copyright (C) 2026 Unvanquished Developers
+
+This file is part of the Unvanquished GPL Source Code (Unvanquished Source Code).
+
+Unvanquished is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Unvanquished is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Unvanquished; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+===========================================================================
+*/
+
+#include "common/Common.h"
+#include "sg_events.h"
+
+#include <algorithm>
+
+namespace {
+struct gameEventSubscription_t
+{
+	GentityRef         self;
+	gameEventHandler_t handler;
+};
+
+std::vector<gameEventSubscription_t> subscriptions[ static_cast<int>( gameEvent_t::NUM_GAME_EVENTS ) ];
+}
+
+void G_SubscribeGameEvent( gentity_t *self, gameEvent_t event, gameEventHandler_t handler )
+{
+	std::vector<gameEventSubscription_t> &list = subscriptions[ Util::ordinal( event ) ];
+
+	// drop subscriptions of freed entities, whose slot may be the one subscribing now
+	list.erase( std::remove_if( list.begin(), list.end(),
+	                            []( const gameEventSubscription_t &s ) { return !s.self; } ),
+	            list.end() );
+
+	auto position = std::upper_bound( list.begin(), list.end(), self->num(),
+	                                  []( int num, const gameEventSubscription_t &s ) { return num < s.self->num(); } );
+	list.insert( position, { self, handler } );
+}
+
+void G_PublishGameEvent( gameEvent_t event, const gameEventData_t &data )
+{
+	// handlers may free entities or subscribe new ones, so work on a copy
+	std::vector<gameEventSubscription_t> list = subscriptions[ Util::ordinal( event ) ];
+
+	for ( const gameEventSubscription_t &subscription : list )
+	{
+		if ( subscription.self )
+		{
+			subscription.handler( subscription.self.entity, data );
+		}
+	}
+}
+
+void G_ResetGameEvents()
+{
+	for ( std::vector<gameEventSubscription_t> &list : subscriptions )
+	{
+		list.clear();
+	}
+}
@@ -0,0 +1,58 @@
+/*
+===========================================================================
+
+Unvanquished GPL Source Code
+Copyright (C) 2026 Unvanquished Developers
+
+This file is part of the Unvanquished GPL Source Code (Unvanquished Source Code).
+
+Unvanquished is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Unvanquished is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Unvanquished; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+===========================================================================
+*/
+
+#ifndef SG_EVENTS_H_
+#define SG_EVENTS_H_
+
+#include "sg_local.h"
+
+// Game state changes that map entities can wait for instead of polling.
+enum class gameEvent_t
+{
+	MATCH_START,          // the warmup is over
+	STAGE_CHANGE,         // team, previousStage, newStage
+	MATCH_END,            // team won, TEAM_NONE for a draw
+	MAIN_BUILDABLE_STATE, // team's active main buildable appeared or disappeared, see active
+
+	NUM_GAME_EVENTS
+};
+
+struct gameEventData_t
+{
+	team_t team;
+	int    previousStage;
+	int    newStage;
+	bool   active;
+};
+
+using gameEventHandler_t = void ( * )( gentity_t *self, const gameEventData_t &data );
+
+// Handlers run in the order of their entity numbers. Subscriptions of freed entities are
+// dropped automatically.
+void G_SubscribeGameEvent( gentity_t *self, gameEvent_t event, gameEventHandler_t handler );
+void G_PublishGameEvent( gameEvent_t event, const gameEventData_t &data );
+void G_ResetGameEvents();
+
+#endif // SG_EVENTS_H_
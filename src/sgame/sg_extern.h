@@ -133,6 +133,8 @@ extern Cvar::Cvar<bool> g_enableVsays;
 
 extern Cvar::Cvar<int> g_floodMaxDemerits;
 extern Cvar::Cvar<int> g_floodMinTime;
+extern Cvar::Cvar<float> g_cmdRate;
+extern Cvar::Cvar<float> g_cmdBurst;
 extern Cvar::Cvar<int> g_teamStatus;
 
 extern Cvar::Cvar<int> g_tacticMilliseconds;
@@ -0,0 +1,265 @@
+/*
+===========================================================================
+
+Unvanquished GPL Source Code
+Copyright (C) 2026 Unvanquished Developers
+
+This file is part of the Unvanquished GPL Source Code (Unvanquished Source Code).
+
+Unvanquished is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Unvanquished is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Unvanquished; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+===========================================================================
+*/
+
+#include "common/Common.h"
+#include "sg_hostiles.h"
+#include "Entities.h"
+#include "CBSE.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <glm/geometric.hpp>
+
+static Cvar::Cvar<bool> g_hostileCache("g_hostileCache", "share hostile client lists and line of fire traces between defensive buildables during a frame", Cvar::NONE, true);
+
+namespace {
+// Horizontal size of the buckets; vertical distance is only checked per candidate.
+constexpr float HOSTILE_CELL_SIZE = 512.0f;
+
+struct hostileCandidate_t
+{
+	int    num;
+	team_t team;
+	int    cellX, cellY;
+};
+
+struct hostileSnapshot_t
+{
+	bool built;
+
+	// in ForEntities<ClientComponent> order
+	std::vector<hostileCandidate_t> candidates;
+
+	// indexes into candidates, per team they are hostile to, by cell
+	std::unordered_map<uint64_t, std::vector<int>> cells[ NUM_TEAMS ];
+	std::vector<int> all[ NUM_TEAMS ];
+};
+
+struct hostileStats_t
+{
+	int frames;
+	int builds;
+	int64_t queries;
+	int64_t candidates;      // clients the queries had to look at
+	int64_t skipped;         // hostile clients excluded by the buckets without being looked at
+	int64_t traces;
+	int64_t cachedTraces;
+};
+
+bool frameOpen = false;
+hostileSnapshot_t snapshot;
+std::unordered_map<int, bool> lineOfFire;
+hostileStats_t stats;
+
+int CellCoordinate( float x )
+{
+	return static_cast<int>( floorf( x / HOSTILE_CELL_SIZE ) );
+}
+
+uint64_t CellKey( int x, int y )
+{
+	return ( static_cast<uint64_t>( static_cast<uint32_t>( x ) ) << 32 ) | static_cast<uint32_t>( y );
+}
+
+void BuildSnapshot()
+{
+	snapshot.candidates.clear();
+
+	for ( int team = 0; team < NUM_TEAMS; team++ )
+	{
+		snapshot.cells[ team ].clear();
+		snapshot.all[ team ].clear();
+	}
+
+	ForEntities<ClientComponent>( []( Entity &entity, ClientComponent& ) {
+		team_t team = G_Team( entity.oldEnt );
+
+		if ( !G_IsPlayableTeam( team ) )
+		{
+			return;
+		}
+
+		const vec3_t &origin = entity.oldEnt->s.origin;
+		snapshot.candidates.push_back( { entity.oldEnt->num(), team, CellCoordinate( origin[ 0 ] ), CellCoordinate( origin[ 1 ] ) } );
+	} );
+
+	for ( int i = 0; i < static_cast<int>( snapshot.candidates.size() ); i++ )
+	{
+		const hostileCandidate_t &candidate = snapshot.candidates[ i ];
+
+		for ( team_t team = TEAM_NONE; ( team = G_IterateTeams( team ) ); )
+		{
+			if ( team == candidate.team )
+			{
+				continue;
+			}
+
+			snapshot.cells[ team ][ CellKey( candidate.cellX, candidate.cellY ) ].push_back( i );
+			snapshot.all[ team ].push_back( i );
+		}
+	}
+
+	snapshot.built = true;
+	stats.builds++;
+}
+}
+
+void G_BeginHostileFrame()
+{
+	frameOpen = g_hostileCache.Get();
+	snapshot.built = false;
+	lineOfFire.clear();
+	stats.frames++;
+}
+
+void G_EndHostileFrame()
+{
+	frameOpen = false;
+	snapshot.built = false;
+	lineOfFire.clear();
+}
+
+std::vector<Entity*> G_HostileClients( team_t team, const glm::vec3 &origin, float range )
+{
+	std::vector<Entity*> result;
+
+	if ( !G_IsPlayableTeam( team ) )
+	{
+		return result;
+	}
+
+	if ( !frameOpen || !snapshot.built )
+	{
+		BuildSnapshot();
+	}
+
+	const std::vector<int> &all = snapshot.all[ team ];
+	std::vector<int> indexes;
+
+	// only look the buckets up if that is cheaper than going through all hostiles
+	int span = range < HOSTILE_CELL_SIZE * MAX_CLIENTS ? CellCoordinate( 2.0f * range ) + 2 : MAX_CLIENTS;
+
+	if ( static_cast<size_t>( span * span ) < all.size() )
+	{
+		int minX = CellCoordinate( origin[ 0 ] - range ), maxX = CellCoordinate( origin[ 0 ] + range );
+		int minY = CellCoordinate( origin[ 1 ] - range ), maxY = CellCoordinate( origin[ 1 ] + range );
+
+		for ( int x = minX; x <= maxX; x++ )
+		{
+			for ( int y = minY; y <= maxY; y++ )
+			{
+				auto cell = snapshot.cells[ team ].find( CellKey( x, y ) );
+
+				if ( cell != snapshot.cells[ team ].end() )
+				{
+					indexes.insert( indexes.end(), cell->second.begin(), cell->second.end() );
+				}
+			}
+		}
+
+		std::sort( indexes.begin(), indexes.end() );
+	}
+	else
+	{
+		indexes = all;
+	}
+
+	stats.queries++;
+	stats.candidates += indexes.size();
+	stats.skipped += all.size() - indexes.size();
+
+	for ( int index : indexes )
+	{
+		gentity_t *ent = &g_entities[ snapshot.candidates[ index ].num ];
+
+		// the client's entity may have been replaced since the snapshot was taken
+		if ( !ent->inuse || !ent->entity || !ent->entity->Get<ClientComponent>() )
+		{
+			continue;
+		}
+
+		if ( glm::distance( VEC2GLM( ent->s.origin ), origin ) <= range )
+		{
+			result.push_back( ent->entity );
+		}
+	}
+
+	if ( !frameOpen )
+	{
+		snapshot.built = false;
+	}
+
+	return result;
+}
+
+bool G_CachedLineOfFire( const gentity_t *from, const gentity_t *to )
+{
+	if ( !frameOpen || !from || !to )
+	{
+		return G_LineOfFire( from, to );
+	}
+
+	int key = from->num() * MAX_GENTITIES + to->num();
+	auto it = lineOfFire.find( key );
+
+	if ( it != lineOfFire.end() )
+	{
+		stats.cachedTraces++;
+		return it->second;
+	}
+
+	stats.traces++;
+	bool result = G_LineOfFire( from, to );
+	lineOfFire.emplace( key, result );
+	return result;
+}
+
+class HostileStatsCmd : public Cmd::StaticCmd
+{
+public:
+	HostileStatsCmd() : StaticCmd( "hostileStats", Cmd::SGAME_VM, "print how much work the shared defensive buildable target lists save" ) {}
+	void Run( const Cmd::Args& args ) const override
+	{
+		if ( args.Argc() > 1 && args.Argv( 1 ) == "reset" )
+		{
+			stats = {};
+			return;
+		}
+
+		int frames = std::max( stats.frames, 1 );
+		int64_t lookups = stats.candidates + stats.skipped;
+		int64_t traces = stats.traces + stats.cachedTraces;
+
+		Print( "frames:     %d, snapshots built: %d", stats.frames, stats.builds );
+		Print( "queries:    %.2f per frame", static_cast<float>( stats.queries ) / frames );
+		Print( "candidates: %.2f per frame looked at, %.2f per frame skipped by the buckets (%.1f%%)",
+		       static_cast<float>( stats.candidates ) / frames, static_cast<float>( stats.skipped ) / frames,
+		       lookups ? 100.0f * stats.skipped / lookups : 0.0f );
+		Print( "traces:     %.2f per frame traced, %.2f per frame reused (%.1f%%)",
+		       static_cast<float>( stats.traces ) / frames, static_cast<float>( stats.cachedTraces ) / frames,
+		       traces ? 100.0f * stats.cachedTraces / traces : 0.0f );
+	}
+};
+static HostileStatsCmd hostileStatsCmdRegistration;
@@ -0,0 +1,45 @@
+/*
+===========================================================================
+
+Unvanquished GPL Source Code
+Copyright (C) 2026 Unvanquished Developers
+
+This file is part of the Unvanquished GPL Source Code (Unvanquished Source Code).
+
+Unvanquished is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Unvanquished is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Unvanquished; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+===========================================================================
+*/
+
+#ifndef SG_HOSTILES_H_
+#define SG_HOSTILES_H_
+
+#include "sg_local.h"
+
+// Per-frame snapshot of the clients that defensive buildables can target, bucketed by position,
+// and a memo of line of fire traces. Both are only kept while entities think in G_RunFrame;
+// outside of that window queries are answered from scratch.
+void G_BeginHostileFrame();
+void G_EndHostileFrame();
+
+// Clients on a playable team other than team whose origin is within range of origin, in the
+// order ForEntities<ClientComponent> visits them. Callers still need to check liveness and
+// their other criteria, as these can change during the frame.
+std::vector<Entity*> G_HostileClients( team_t team, const glm::vec3 &origin, float range );
+
+// G_LineOfFire, remembered for the rest of the frame.
+bool G_CachedLineOfFire( const gentity_t *from, const gentity_t *to );
+
+#endif // SG_HOSTILES_H_
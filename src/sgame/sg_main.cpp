@@ -32,7 +32,13 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "backend/CBSEBackend.h"
 #include "botlib/bot_api.h"
 #include "common/FileSystem.h"
+#include "engine/qcommon/q_unicode.h"
 #include "lua/Interpreter.h"
+#include "sg_events.h"
+#include "sg_hostiles.h"
+#include "sg_service.h"
+
+#include <chrono>
 
 #define INTERMISSION_DELAY_TIME 1000
 
@@ -71,6 +77,8 @@ Cvar::Cvar<bool> g_lockTeamsAtStart("g_lockTeamsAtStart", "(internal use) lock t
 Cvar::Cvar<std::string> g_logFile("g_logFile", "sgame log file, relative to <homepath>/game/", Cvar::NONE, "games.log");
 Cvar::Cvar<int> g_logGameplayStatsFrequency("g_logGameplayStatsFrequency", "log gameplay stats every x seconds", Cvar::NONE, 10);
 Cvar::Cvar<bool> g_logFileSync("g_logFileSync", "flush g_logFile on every write", Cvar::NONE, false);
+static Cvar::Cvar<std::string> g_logFileJSON("g_logFileJSON", "sgame log file with one JSON object per line, relative to <homepath>/game/, empty to disable", Cvar::NONE, "");
+static Cvar::Range<Cvar::Cvar<int>> g_logFileBufferSize("g_logFileBufferSize", "amount of buffered log data in bytes that triggers a write before the end of the frame", Cvar::NONE, 16384, 0, 1 << 20);
 Cvar::Cvar<bool> g_allowVote("g_allowVote", "whether votes of any kind are allowed", Cvar::NONE, true);
 Cvar::Cvar<int> g_voteLimit("g_voteLimit", "max votes per player per round", Cvar::NONE, 5);
 Cvar::Cvar<int> g_extendVotesPercent("g_extendVotesPercent", "percentage required for extend timelimit vote", Cvar::NONE, 74);
@@ -226,6 +234,8 @@ Cvar::Cvar<float> g_sayAreaRange("g_sayAreaRange", "distance for area chat messa
 
 Cvar::Cvar<int> g_floodMaxDemerits("g_floodMaxDemerits", "client message rate control (lower = stricter)", Cvar::NONE, 5000);
 Cvar::Cvar<int> g_floodMinTime("g_floodMinTime", "mute period after flooding, in milliseconds", Cvar::NONE, 2000);
+Cvar::Cvar<float> g_cmdRate("g_cmdRate", "client command budget regained per second, 0 = unlimited", Cvar::NONE, 8);
+Cvar::Cvar<float> g_cmdBurst("g_cmdBurst", "maximum client command budget", Cvar::NONE, 24);
 Cvar::Cvar<int> g_teamStatus("g_teamStatus", "allow /teamstatus command. 0 = disabled, otherwise you can only /teamstatus every <g_teamStatus> seconds.", Cvar::NONE, 5);
 
 Cvar::Cvar<int> g_tacticMilliseconds("g_tacticMilliseconds", "clients can only /tactic every <g_tacticMilliseconds> milliseconds, -1 = disabled.", Cvar::NONE, 1000);
@@ -394,13 +404,12 @@ static void G_FindEntityGroups()
 				// make sure that targets only point at the master
 				for (int k = 0; comparedEntity->mapEntity.names[k]; k++)
 				{
-					if ( masterEntity->mapEntity.names[k] ) {
-						BG_Free( masterEntity->mapEntity.names[k] );
-					}
-
 					masterEntity->mapEntity.names[k] = comparedEntity->mapEntity.names[k];
 					comparedEntity->mapEntity.names[k] = nullptr;
 				}
+
+				G_UpdateEntityIndex( masterEntity );
+				G_UpdateEntityIndex( comparedEntity );
 			}
 		}
 	}
@@ -466,6 +475,34 @@ void G_MapConfigs( Str::StringRef mapname, Str::StringRef layout )
 	trap_SendConsoleCommand( "set g_mapRestarted \"\"" );
 }
 
+/*
+============
+mapLoadTimer_t
+
+Times the stages of loading a map, to be logged in one line once done.
+============
+*/
+struct mapLoadTimer_t
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::time_point last = start;
+	std::string stages;
+
+	void Stage( const char *name )
+	{
+		auto now = std::chrono::steady_clock::now();
+		stages += Str::Format( " %s %.1fms,", name,
+		                       std::chrono::duration<float, std::milli>( now - last ).count() );
+		last = now;
+	}
+
+	void Print()
+	{
+		Log::Notice( "map loaded in %.1fms:%s", std::chrono::duration<float, std::milli>( last - start ).count(),
+		             stages.substr( 0, stages.size() - 1 ) );
+	}
+};
+
 /*
 ============
 G_InitGame
@@ -525,6 +562,17 @@ void G_InitGame( int levelTime, int randomSeed, bool inClient )
 		Log::Notice( "Not logging to disk" );
 	}
 
+	if ( !g_logFileJSON.Get().empty() )
+	{
+		trap_FS_FOpenFile( g_logFileJSON.Get().c_str(), &level.logJSONFile,
+		                   g_logFileSync.Get() ? fsMode_t::FS_APPEND_SYNC : fsMode_t::FS_APPEND );
+
+		if ( !level.logJSONFile )
+		{
+			Log::Warn("Couldn't open JSON logfile: %s", g_logFileJSON.Get() );
+		}
+	}
+
 	// gameplay statistics logging
 	// TODO: Move this in a seperate function
 	if ( g_logGameplayStatsFrequency.Get() > 0 )
@@ -590,10 +638,16 @@ void G_InitGame( int levelTime, int randomSeed, bool inClient )
 	// always leave room for the max number of clients, even if they aren't all used, so numbers
 	// inside that range are NEVER anything but clients
 	level.num_entities = MAX_CLIENTS;
+	G_ResetEntitySlots();
+	G_ResetEntityIndex();
+	G_ResetInternedStrings();
+	G_ResetGameEvents();
+	G_ResetSupport();
+	G_ResetBuildPreviews();
 
 	for( int i = 0; i < MAX_CLIENTS; i++ )
 	{
-		g_entities[ i ].classname = BG_strdup( "clientslot" );
+		G_SetClassname( &g_entities[ i ], "clientslot" );
 	}
 
 	// let the server system know where the entites are
@@ -609,37 +663,48 @@ void G_InitGame( int levelTime, int randomSeed, bool inClient )
 
 	BotAssertionInit();
 
+	mapLoadTimer_t mapLoadTimer;
+
 	// retrieve map name and layout to load configs.
 	{
 		std::string map = Cvar::GetValue( "mapname");
 		std::string layout = Cvar::GetValue( "layout" );
 		G_MapConfigs( map, layout );
 	}
+	mapLoadTimer.Stage( "configs" );
 
 	level.spawning = true;
 
-	// parse the key/value pairs and spawn gentities
+	// parse the key/value pairs, then spawn gentities
+	G_ParseEntitiesFromString();
+	mapLoadTimer.Stage( "parse" );
+
 	G_SpawnEntitiesFromString();
 
 	// add any fake entities
 	G_SpawnFakeEntities();
+	mapLoadTimer.Stage( "spawn" );
 
 	BaseClustering::Init();
 
 	// load up a custom building layout if there is one
 	G_LayoutLoad();
+	mapLoadTimer.Stage( "layout" );
 
 	// Initialize item locking state
 	BG_InitUnlockackables();
 
 	G_FindEntityGroups();
 	G_InitSetEntities();
+	mapLoadTimer.Stage( "groups" );
 
 	G_CheckPmoveParamChanges();
 
 	G_InitDamageLocations();
+	mapLoadTimer.Stage( "damage regions" );
 
 	G_InitMapRotations();
+	mapLoadTimer.Stage( "rotations" );
 
 	G_InitSpawnQueue( &level.team[ TEAM_ALIENS ].spawnQueue );
 	G_InitSpawnQueue( &level.team[ TEAM_HUMANS ].spawnQueue );
@@ -653,6 +718,8 @@ void G_InitGame( int levelTime, int randomSeed, bool inClient )
 
 	level.voices = BG_VoiceInit();
 	BG_PrintVoices( level.voices, g_debugVoices.Get() );
+	mapLoadTimer.Stage( "voices" );
+	mapLoadTimer.Print();
 
 	// Spend build points for layout buildables.
 	for (team_t team = TEAM_NONE; (team = G_IterateTeams(team)); ) {
@@ -751,16 +818,23 @@ void G_ShutdownGame( int /* restart */ )
 	{
 		G_LogPrintf( "ShutdownGame:" );
 		G_LogPrintf( "------------------------------------------------------------" );
-		trap_FS_FCloseFile( level.logFile );
-		level.logFile = 0;
 	}
 
 	// finalize logging of gameplay statistics
 	if ( level.logGameplayFile )
 	{
 		G_LogGameplayStats( LOG_GAMEPLAY_STATS_FOOTER );
-		trap_FS_FCloseFile( level.logGameplayFile );
-		level.logGameplayFile = 0;
+	}
+
+	G_LogFlush();
+
+	for ( fileHandle_t *file : { &level.logFile, &level.logJSONFile, &level.logGameplayFile } )
+	{
+		if ( *file )
+		{
+			trap_FS_FCloseFile( *file );
+			*file = 0;
+		}
 	}
 
 	// write all the non-bot client session data so we can get it back
@@ -1562,6 +1636,151 @@ void G_AdminMessage( gentity_t *ent, const char *msg )
 	             msg );
 }
 
+/*
+================================================================================
+
+Log files
+
+Lines are collected in memory and written once per frame, or earlier if a lot
+of data piles up, instead of issuing file writes for every line.
+
+================================================================================
+*/
+
+static std::string logFileBuffer;
+static std::string logJSONFileBuffer;
+static std::string logGameplayFileBuffer;
+
+static void G_LogFlushBuffer( fileHandle_t file, std::string &buffer )
+{
+	if ( file && !buffer.empty() )
+	{
+		trap_FS_Write( buffer.data(), buffer.size(), file );
+	}
+
+	buffer.clear();
+}
+
+static void G_LogBuffered( fileHandle_t file, std::string &buffer, Str::StringRef text )
+{
+	if ( !file )
+	{
+		return;
+	}
+
+	buffer.append( text.data(), text.size() );
+
+	if ( g_logFileSync.Get() || buffer.size() >= (size_t) g_logFileBufferSize.Get() )
+	{
+		G_LogFlushBuffer( file, buffer );
+	}
+}
+
+/*
+=================
+G_LogFlush
+
+Write out everything that was logged since the last flush.
+=================
+*/
+void G_LogFlush()
+{
+	G_LogFlushBuffer( level.logFile, logFileBuffer );
+	G_LogFlushBuffer( level.logJSONFile, logJSONFileBuffer );
+	G_LogFlushBuffer( level.logGameplayFile, logGameplayFileBuffer );
+}
+
+static void G_LogAppendJSONString( std::string &out, Str::StringRef in )
+{
+	out += '"';
+
+	for ( size_t i = 0; i < in.size(); )
+	{
+		char c = in[ i ];
+
+		switch ( c )
+		{
+			case '"':  out += "\\\""; i++; continue;
+			case '\\': out += "\\\\"; i++; continue;
+			case '\n': out += "\\n"; i++; continue;
+			case '\r': out += "\\r"; i++; continue;
+			case '\t': out += "\\t"; i++; continue;
+		}
+
+		if ( (unsigned char) c < 0x20 )
+		{
+			out += Str::Format( "\\u%04x", (int) (unsigned char) c );
+			i++;
+			continue;
+		}
+
+		if ( (unsigned char) c < 0x80 )
+		{
+			out += c;
+			i++;
+			continue;
+		}
+
+		// names and chat may hold any bytes, only copy well-formed UTF-8 sequences
+		size_t width = Q_UTF8_Width( in.data() + i );
+		bool valid = width > 1 && i + width <= in.size();
+
+		for ( size_t j = 1; valid && j < width; j++ )
+		{
+			valid = ( in[ i + j ] & 0xC0 ) == 0x80;
+		}
+
+		if ( valid )
+		{
+			int cp = Q_UTF8_CodePoint( in.data() + i );
+
+			// reject overlong forms, surrogates and anything beyond U+10FFFF
+			valid = cp > 0 && cp <= 0x10FFFF && ( cp < 0xD800 || cp > 0xDFFF ) &&
+			        static_cast<size_t>( Q_UTF8_WidthCP( cp ) ) == width;
+		}
+
+		if ( valid )
+		{
+			out.append( in.data() + i, width );
+			i += width;
+		}
+		else
+		{
+			out += "\\ufffd";
+			i++;
+		}
+	}
+
+	out += '"';
+}
+
+/*
+=================
+G_LogJSON
+
+Write a log line as a JSON object with the match time, the event name (the
+word before the first colon, if any) and the message.
+=================
+*/
+static void G_LogJSON( const char *message )
+{
+	const char *colon = strchr( message, ':' );
+	std::string event;
+
+	if ( colon && colon != message && !memchr( message, ' ', colon - message ) )
+	{
+		event.assign( message, colon - message );
+	}
+
+	std::string line = Str::Format( "{\"time\":%d,\"event\":", level.matchTime );
+	G_LogAppendJSONString( line, event );
+	line += ",\"message\":";
+	G_LogAppendJSONString( line, message );
+	line += "}\n";
+
+	G_LogBuffered( level.logJSONFile, logJSONFileBuffer, line );
+}
+
 /*
 =================
 G_LogPrintf
@@ -1598,14 +1817,22 @@ void PRINTF_LIKE(1) G_LogPrintf( const char *fmt, ... )
 		Log::Notice( decolored + 7 );
 	}
 
-	if ( !level.logFile )
+	if ( !level.logFile && !level.logJSONFile )
 	{
 		return;
 	}
 
 	Color::StripColors( string, decolored, sizeof( decolored ) );
-	trap_FS_Write( decolored, strlen( decolored ), level.logFile );
-    trap_FS_Write( "\n", 1, level.logFile );
+
+	if ( level.logFile )
+	{
+		G_LogBuffered( level.logFile, logFileBuffer, Str::Format( "%s\n", decolored ) );
+	}
+
+	if ( level.logJSONFile )
+	{
+		G_LogJSON( decolored + std::min( tslen, strlen( decolored ) ) );
+	}
 }
 
 /*
@@ -1788,7 +2015,7 @@ static void G_LogGameplayStats( int state )
 			return;
 	}
 
-	trap_FS_Write( logline, strlen( logline ), level.logGameplayFile );
+	G_LogBuffered( level.logGameplayFile, logGameplayFileBuffer, logline );
 
 	if ( state == LOG_GAMEPLAY_STATS_BODY )
 	{
@@ -2233,6 +2460,9 @@ void G_RunFrame( int levelTime )
 	int        msec;
 	static int ptime3000 = 0;
 
+	// write what was logged between frames
+	G_LogFlush();
+
 	// if we are waiting for the level to restart, do nothing
 	if ( level.restarted )
 	{
@@ -2309,10 +2539,21 @@ void G_RunFrame( int levelTime )
 
 	std::array<int, BA_NUM_BUILDABLES> numBuildables = {};
 
+	// defensive buildables share their target searches while entities think
+	G_BeginHostileFrame();
+
 	// go through all allocated objects
 	ent = &g_entities[ 0 ];
 	for ( i = 0; i < level.num_entities; i++, ent++ )
 	{
+		// once the clients have moved, see which support buildables they are at and let
+		// the missiles share their entity lookups
+		if ( i == MAX_CLIENTS )
+		{
+			G_UpdateServiceAreas();
+			MissileComponent::BeginMoves();
+		}
+
 		if ( !ent->inuse ) continue;
 
 		// clear events that are too old
@@ -2388,6 +2629,8 @@ void G_RunFrame( int levelTime )
 		}
 	}
 
+	MissileComponent::EndMoves();
+
 	// ThinkingComponent should have been called already but who knows maybe we forgot some.
 	ForEntities<ThinkingComponent>([](Entity& entity, ThinkingComponent& thinkingComponent) {
 		// A newly created entity can randomly run things, or not, in the above loop over
@@ -2400,6 +2643,8 @@ void G_RunFrame( int levelTime )
 		}
 	});
 
+	G_EndHostileFrame();
+
 	// perform final fixups on the players
 	ent = &g_entities[ 0 ];
 
@@ -2428,6 +2673,10 @@ void G_RunFrame( int levelTime )
 	G_SpawnClients( TEAM_HUMANS );
 	G_UpdateZaps( msec );
 	Beacon::Frame( );
+	Lua::UpdateTimers( level.time );
+
+	// send this frame's momentum changes
+	G_PublishMomentum();
 
 	G_PrepareEntityNetCode();
 
@@ -2457,6 +2706,8 @@ void G_RunFrame( int levelTime )
 	// update some configstrings
 	G_TransmitGameplayCvars();
 	G_TransmitBPVampire();
+
+	G_LogFlush();
 }
 
 void G_PrepareEntityNetCode() {
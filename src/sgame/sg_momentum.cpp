@@ -30,7 +30,7 @@ along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
 // definitions
 // -----------
 
-// This also sets a minimum frequency for G_UpdateUnlockables
+// Momentum decays in steps this far apart, see also MOMENTUM_DECAY_PUBLISH_PERIOD
 #define DECREASE_MOMENTUM_PERIOD  500
 
 // Used for legacy stage sensors
@@ -65,55 +65,104 @@ static const char *MomentumTypeToReason( momentum_t type )
 }
 
 /**
- * Has to be called whenever the momentum of a team has been modified.
+ * Momentum changes of the current frame, published once by G_PublishMomentum so that a
+ * mass kill or a base going down doesn't update every client and sensor per reward.
  */
-static void MomentumChanged()
+static struct
 {
-	int       playerNum;
-	gentity_t *player;
-	gclient_t *client;
-	team_t    team;
+	bool  changed;
+	int   lastPublish;
 
-	// send to clients
-	for ( playerNum = 0; playerNum < level.maxclients; playerNum++ )
+	// momentum event popups, summed per client and per team
+	float clientGain[ MAX_CLIENTS ], clientLoss[ MAX_CLIENTS ];
+	float teamGain[ NUM_TEAMS ], teamLoss[ NUM_TEAMS ];
+} momentumDelta;
+
+/**
+ * Momentum decay is only published when clients would see it or the unlockables haven't been
+ * checked for this long.
+ */
+#define MOMENTUM_DECAY_PUBLISH_PERIOD 5000
+
+static int MomentumToPersistant( float momentum )
+{
+	return ( short ) ( momentum * 10.0f + 0.5f );
+}
+
+static void SendMomentumEvent( gentity_t *event, float amount )
+{
+	// TODO: Use more bits for momentum value
+	event->s.eventParm = 0;
+	event->s.otherEntityNum = 0;
+	event->s.otherEntityNum2 = ( int )( fabs( amount ) * 10.0f + 0.5f );
+	event->s.groundEntityNum = amount < 0.0f;
+}
+
+static void SendMomentumEvents()
+{
+	for ( int clientNum = 0; clientNum < level.maxclients; clientNum++ )
 	{
-		player = &g_entities[ playerNum ];
-		client = player->client;
+		float gain = momentumDelta.clientGain[ clientNum ];
+		float loss = momentumDelta.clientLoss[ clientNum ];
 
-		if ( !client )
+		momentumDelta.clientGain[ clientNum ] = momentumDelta.clientLoss[ clientNum ] = 0.0f;
+
+		if ( ( gain == 0.0f && loss == 0.0f ) || !g_entities[ clientNum ].inuse )
 		{
 			continue;
 		}
 
-		team = (team_t) client->pers.team;
+		gclient_t *client = g_entities[ clientNum ].client;
 
-		if ( team > TEAM_NONE && team < NUM_TEAMS )
+		for ( float amount : { gain, loss } )
 		{
-			client->ps.persistant[ PERS_MOMENTUM ] = ( short )
-				( level.team[ team ].momentum * 10.0f + 0.5f );
+			if ( amount != 0.0f )
+			{
+				gentity_t *event = G_NewTempEntity( VEC2GLM( client->ps.origin ), EV_MOMENTUM );
+				event->r.svFlags = SVF_SINGLECLIENT;
+				event->r.singleClient = clientNum;
+				SendMomentumEvent( event, amount );
+			}
 		}
 	}
 
-	// check team progress
-	G_UpdateUnlockables();
+	for ( int team = TEAM_NONE + 1; team < NUM_TEAMS; team++ )
+	{
+		float gain = momentumDelta.teamGain[ team ];
+		float loss = momentumDelta.teamLoss[ team ];
+
+		momentumDelta.teamGain[ team ] = momentumDelta.teamLoss[ team ] = 0.0f;
+
+		for ( float amount : { gain, loss } )
+		{
+			if ( amount != 0.0f )
+			{
+				gentity_t *event = G_NewTempEntity( VEC2GLM( vec3_origin ), EV_MOMENTUM );
+				event->r.svFlags = ( SVF_BROADCAST | SVF_CLIENTMASK );
+				G_TeamToClientmask( (team_t) team, &( event->r.loMask ), &( event->r.hiMask ) );
+				SendMomentumEvent( event, amount );
+			}
+		}
+	}
 }
 
 /**
  * Notifies legacy stage sensors by assuming a certain amount of momentum is a stage.
  *
- * To be called after the team's momentum has been modified.
+ * previous is the momentum the team had when it was last published.
  */
-static void NotifyLegacyStageSensors( team_t team, float amount )
+static void NotifyLegacyStageSensors( team_t team, float previous )
 {
 	int   stage;
 	float momentum;
+	float amount = level.team[ team ].momentum - previous;
 
 	for ( stage = 1; stage < 3; stage++ )
 	{
 		momentum = stage * ( float )MOMENTUM_PER_LEGACY_STAGE;
 
-		if ( ( level.team[ team ].momentum - amount < momentum ) ==
-		     ( level.team[ team ].momentum          > momentum ) )
+		if ( ( previous                    < momentum ) ==
+		     ( level.team[ team ].momentum > momentum ) )
 		{
 			if      ( amount > 0.0f )
 			{
@@ -216,10 +265,8 @@ static float MomentumMod( momentum_t type )
  *
  * Will notify the client who earned it if given, otherwise the whole team, with an event.
  */
-static float AddMomentum( momentum_t type, team_t team, float amount,
-                            gentity_t *source, bool skipChangeHook )
+static float AddMomentum( momentum_t type, team_t team, float amount, gentity_t *source )
 {
-	gentity_t *event = nullptr;
 	gclient_t *client;
 	const char *clientName;
 
@@ -239,11 +286,7 @@ static float AddMomentum( momentum_t type, team_t team, float amount,
 		// add momentum to team
 		level.team[ team ].momentum += amount;
 
-		// run change hook if requested
-		if ( !skipChangeHook )
-		{
-			MomentumChanged();
-		}
+		momentumDelta.changed = true;
 
 		// notify source
 		if ( source )
@@ -252,28 +295,24 @@ static float AddMomentum( momentum_t type, team_t team, float amount,
 
 			if ( client && client->pers.team == team )
 			{
-				event = G_NewTempEntity( VEC2GLM( client->ps.origin ), EV_MOMENTUM );
-				event->r.svFlags = SVF_SINGLECLIENT;
-				event->r.singleClient = client->num();
+				if ( amount > 0.0f )
+				{
+					momentumDelta.clientGain[ client->num() ] += amount;
+				}
+				else
+				{
+					momentumDelta.clientLoss[ client->num() ] += amount;
+				}
 			}
 		}
-		else
+		else if ( amount > 0.0f )
 		{
-			event = G_NewTempEntity( VEC2GLM( vec3_origin ), EV_MOMENTUM );
-			event->r.svFlags = ( SVF_BROADCAST | SVF_CLIENTMASK );
-			G_TeamToClientmask( team, &( event->r.loMask ), &( event->r.hiMask ) );
+			momentumDelta.teamGain[ team ] += amount;
 		}
-		if ( event )
+		else
 		{
-			// TODO: Use more bits for momentum value
-			event->s.eventParm = 0;
-			event->s.otherEntityNum = 0;
-			event->s.otherEntityNum2 = ( int )( fabs( amount ) * 10.0f + 0.5f );
-			event->s.groundEntityNum = amount < 0.0f;
+			momentumDelta.teamLoss[ team ] += amount;
 		}
-
-		// notify legacy stage sensors
-		NotifyLegacyStageSensors( team, amount );
 	}
 
 	if ( g_debugMomentum.Get() > 0 )
@@ -337,11 +376,20 @@ void G_DecreaseMomentum()
 
 		level.team[ team ].momentum += amount;
 
-		// notify legacy stage sensors
-		NotifyLegacyStageSensors( (team_t) team, amount );
+		// small steps only go out once clients would notice them
+		if ( MomentumToPersistant( level.team[ team ].momentum ) !=
+		     MomentumToPersistant( level.team[ team ].publishedMomentum ) )
+		{
+			momentumDelta.changed = true;
+		}
 	}
 
-	MomentumChanged();
+	// lastPublish may be from before a map restart
+	if ( level.time - momentumDelta.lastPublish >= MOMENTUM_DECAY_PUBLISH_PERIOD ||
+	     level.time < momentumDelta.lastPublish )
+	{
+		momentumDelta.changed = true;
+	}
 
 	nextCalculation = level.time + DECREASE_MOMENTUM_PERIOD;
 }
@@ -351,19 +399,7 @@ void G_DecreaseMomentum()
  */
 float G_AddMomentumGeneric( team_t team, float amount )
 {
-	AddMomentum( CONF_GENERIC, team, amount, nullptr, false );
-
-	return amount;
-}
-
-/**
- * Adds momentum.
- *
- * G_AddMomentumEnd has to be called after all G_AddMomentum*Step steps are done.
- */
-float G_AddMomentumGenericStep( team_t team, float amount )
-{
-	AddMomentum( CONF_GENERIC, team, amount, nullptr, true );
+	AddMomentum( CONF_GENERIC, team, amount, nullptr );
 
 	return amount;
 }
@@ -412,7 +448,7 @@ float G_AddMomentumForBuilding( gentity_t *buildable )
 		builder = nullptr;
 	}
 
-	reward = AddMomentum( CONF_BUILDING, team, value, builder, false );
+	reward = AddMomentum( CONF_BUILDING, team, value, builder );
 
 	// Save reward with buildable so it can be reverted
 	buildable->momentumEarned = reward;
@@ -448,15 +484,13 @@ float G_RemoveMomentumForDecon( gentity_t *buildable, gentity_t *deconner )
 	// Remove only partial momentum as the lost health fraction awards momentum to the enemy.
 	value *= Entities::HealthFraction(buildable);
 
-	return AddMomentum( CONF_DECONSTRUCTING, team, -value, deconner, false );
+	return AddMomentum( CONF_DECONSTRUCTING, team, -value, deconner );
 }
 
 /**
  * Adds momentum for destroying a buildable.
- *
- * G_AddMomentumEnd has to be called after all G_AddMomentum*Step steps are done.
  */
-float G_AddMomentumForDestroyingStep( gentity_t *buildable, gentity_t *attacker, float amount )
+float G_AddMomentumForDestroying( gentity_t *buildable, gentity_t *attacker, float amount )
 {
 	team_t team;
 
@@ -474,15 +508,13 @@ float G_AddMomentumForDestroyingStep( gentity_t *buildable, gentity_t *attacker,
 
 	team = (team_t) attacker->client->pers.team;
 
-	return AddMomentum( CONF_DESTROYING, team, amount, attacker, true );
+	return AddMomentum( CONF_DESTROYING, team, amount, attacker );
 }
 
 /**
  * Adds momentum for killing a player.
- *
- * G_AddMomentumEnd has to be called after all G_AddMomentum*Step steps are done.
  */
-float G_AddMomentumForKillingStep( gentity_t *victim, gentity_t *attacker, float share )
+float G_AddMomentumForKilling( gentity_t *victim, gentity_t *attacker, float share )
 {
 	float  value;
 	team_t team;
@@ -502,13 +534,57 @@ float G_AddMomentumForKillingStep( gentity_t *victim, gentity_t *attacker, float
 	value = BG_GetPlayerValue( victim->client->ps ) * MOMENTUM_PER_CREDIT * share;
 	team  = (team_t) attacker->client->pers.team;
 
-	return AddMomentum( CONF_KILLING, team, value, attacker, true );
+	return AddMomentum( CONF_KILLING, team, value, attacker );
 }
 
 /**
- * Has to be called after the last G_AddMomentum*Step step.
+ * Sends momentum to clients, and the changes of this frame to sensors and team progress.
+ *
+ * Called once per frame, after everything that can award momentum.
  */
-void G_AddMomentumEnd()
+void G_PublishMomentum()
 {
-	MomentumChanged();
+	int       playerNum;
+	gentity_t *player;
+	gclient_t *client;
+	team_t    team;
+
+	// send to clients every frame, so players joining a team see its momentum right away
+	for ( playerNum = 0; playerNum < level.maxclients; playerNum++ )
+	{
+		player = &g_entities[ playerNum ];
+		client = player->client;
+
+		if ( !client )
+		{
+			continue;
+		}
+
+		team = (team_t) client->pers.team;
+
+		if ( team > TEAM_NONE && team < NUM_TEAMS )
+		{
+			client->ps.persistant[ PERS_MOMENTUM ] = MomentumToPersistant( level.team[ team ].momentum );
+		}
+	}
+
+	if ( !momentumDelta.changed )
+	{
+		return;
+	}
+
+	SendMomentumEvents();
+
+	// check team progress
+	G_UpdateUnlockables();
+
+	// notify legacy stage sensors
+	for ( int t = TEAM_NONE + 1; t < NUM_TEAMS; t++ )
+	{
+		NotifyLegacyStageSensors( (team_t) t, level.team[ t ].publishedMomentum );
+		level.team[ t ].publishedMomentum = level.team[ t ].momentum;
+	}
+
+	momentumDelta.changed = false;
+	momentumDelta.lastPublish = level.time;
 }
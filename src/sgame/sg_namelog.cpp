@@ -26,6 +26,11 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "common/Common.h"
 #include "sg_local.h"
 
+// Namelogs are only ever appended to level.namelogs, so they are indexed by
+// guid, in list order, along with the tail of the list.
+static std::unordered_map<std::string, std::vector<namelog_t *>, Str::IHash, Str::IEqual> namelogsByGuid;
+static namelog_t *lastNamelog = nullptr;
+
 void G_namelog_cleanup()
 {
 	namelog_t *namelog, *n;
@@ -35,23 +40,31 @@ void G_namelog_cleanup()
 		n = namelog->next;
 		BG_Free( namelog );
 	}
+
+	namelogsByGuid.clear();
+	lastNamelog = nullptr;
 }
 
 void G_namelog_connect( gclient_t *client )
 {
-	namelog_t *n, *p = nullptr;
+	namelog_t *n = nullptr, *p = lastNamelog;
 	int       i;
 	char      *newname;
 
-	for ( n = level.namelogs; n; p = n, n = n->next )
+	// the list is dropped without cleanup when the level is reset
+	if ( !level.namelogs )
 	{
-		if ( n->slot != -1 )
-		{
-			continue;
-		}
+		namelogsByGuid.clear();
+		p = lastNamelog = nullptr;
+	}
+
+	std::vector<namelog_t *> &sameGuid = namelogsByGuid[ client->pers.guid ];
 
-		if ( !Q_stricmp( client->pers.guid, n->guid ) )
+	for ( namelog_t *candidate : sameGuid )
+	{
+		if ( candidate->slot == -1 )
 		{
+			n = candidate;
 			break;
 		}
 	}
@@ -71,6 +84,9 @@ void G_namelog_connect( gclient_t *client )
 			level.namelogs = n;
 			n->id = MAX_CLIENTS;
 		}
+
+		sameGuid.push_back( n );
+		lastNamelog = n;
 	}
 
 	client->pers.namelog = n;
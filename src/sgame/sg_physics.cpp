@@ -24,10 +24,135 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 ===========================================================================
 */
 
+#include <bitset>
+
 #include "common/Common.h"
 #include "sg_local.h"
 #include "sg_cm_world.h"
 
+static Cvar::Cvar<bool> g_physicsFloorTrace(
+	"g_physicsFloorTrace", "trace for the floor of every resting entity periodically and warn when the support graph missed a change",
+	Cvar::NONE, false);
+
+/*
+Support graph
+
+Resting entities only need to look for their floor again when whatever they
+rest on changes, so remember what that is when they come to rest:
+supportOf[ num ] is the groundEntityNum num was last validated against and
+supported[ n ] lists the entities resting on n. The world never changes and
+movers, buildables, corpses and physics objects report when they move or
+go away; entities resting on anything else still trace every PHYSICS_TIME.
+*/
+static int                        supportOf[ MAX_GENTITIES ];
+static std::vector<int>           supported[ MAX_GENTITIES ];
+static std::bitset<MAX_GENTITIES> supportChanged;
+
+static void G_RemoveSupport( int num )
+{
+	int support = supportOf[ num ];
+
+	if ( support == ENTITYNUM_NONE )
+	{
+		return;
+	}
+
+	std::vector<int> &list = supported[ support ];
+	list.erase( std::remove( list.begin(), list.end(), num ), list.end() );
+	supportOf[ num ] = ENTITYNUM_NONE;
+}
+
+static void G_AddSupport( int num, int support )
+{
+	G_RemoveSupport( num );
+
+	if ( support == ENTITYNUM_NONE )
+	{
+		return;
+	}
+
+	supportOf[ num ] = support;
+	supported[ support ].push_back( num );
+}
+
+static bool G_SupportTracked( int support )
+{
+	if ( support == ENTITYNUM_WORLD )
+	{
+		return true;
+	}
+
+	if ( support < 0 || support >= ENTITYNUM_MAX_NORMAL )
+	{
+		return false;
+	}
+
+	const gentity_t *ent = &g_entities[ support ];
+
+	return ent->s.eType == entityType_t::ET_MOVER || ent->s.eType == entityType_t::ET_BUILDABLE ||
+	       ent->s.eType == entityType_t::ET_CORPSE || ent->physicsObject;
+}
+
+void G_ResetSupport()
+{
+	for ( int num = 0; num < MAX_GENTITIES; num++ )
+	{
+		supportOf[ num ] = ENTITYNUM_NONE;
+		supported[ num ].clear();
+	}
+
+	supportChanged.reset();
+}
+
+/*
+================
+G_InvalidateSupport
+
+Everything resting on ent looks for its floor again
+================
+*/
+void G_InvalidateSupport( const gentity_t *ent )
+{
+	for ( int num : supported[ ent->num() ] )
+	{
+		supportChanged[ num ] = true;
+	}
+}
+
+/*
+================
+G_InvalidateRest
+
+ent looks for its floor again, e.g. because a mover passed by
+================
+*/
+void G_InvalidateRest( const gentity_t *ent )
+{
+	supportChanged[ ent->num() ] = true;
+}
+
+/*
+================
+G_ForgetSupport
+
+Called when ent is freed
+================
+*/
+void G_ForgetSupport( const gentity_t *ent )
+{
+	int num = ent->num();
+
+	for ( int dependent : supported[ num ] )
+	{
+		supportOf[ dependent ] = ENTITYNUM_NONE;
+		supportChanged[ dependent ] = true;
+	}
+
+	supported[ num ].clear();
+	G_RemoveSupport( num );
+	supportChanged[ num ] = false;
+}
+
 /*
 ================
 G_Bounce
@@ -75,6 +200,11 @@ static void G_Bounce( gentity_t *ent, trace_t *trace )
 		VectorMA( trace->endpos, 0.5f, trace->plane.normal, trace->endpos );  // make sure it is off ground
 		G_SetOrigin( ent, VEC2GLM( trace->endpos ) );
 		ent->s.groundEntityNum = trace->entityNum;
+
+		if ( ent->s.eType == entityType_t::ET_BUILDABLE )
+		{
+			G_InvalidateBuildablePowerStates();
+		}
 		VectorCopy( trace->plane.normal, ent->s.origin2 );
 		VectorSet( ent->s.pos.trDelta, 0.0f, 0.0f, 0.0f );
 		return;
@@ -122,27 +252,61 @@ void G_Physics( gentity_t *ent )
 		// check think function
 		G_RunThink( ent );
 
-		//check floor infrequently
-		if ( ent->nextPhysicsTime < level.time )
+		if ( !ent->inuse )
+		{
+			return;
+		}
+
+		int  num = ent->num();
+		bool changed = supportChanged[ num ];
+
+		// check floor when the support changed, or infrequently if it can't tell
+		bool periodic = ent->nextPhysicsTime < level.time &&
+		                ( g_physicsFloorTrace.Get() || !G_SupportTracked( ent->s.groundEntityNum ) );
+
+		if ( changed || periodic )
 		{
 			VectorCopy( ent->r.currentOrigin, origin );
 
 			VectorMA( origin, -2.0f, ent->s.origin2, origin );
 
-			trap_Trace( &tr, ent->r.currentOrigin, ent->r.mins, ent->r.maxs, origin, ent->num(),
+			trap_Trace( &tr, ent->r.currentOrigin, ent->r.mins, ent->r.maxs, origin, num,
 			            ent->clipmask, 0 );
 
 			if ( tr.fraction == 1.0f )
 			{
+				if ( !changed && G_SupportTracked( ent->s.groundEntityNum ) )
+				{
+					Log::Warn( "support graph missed %s losing its ground %d", etos( ent ), ent->s.groundEntityNum );
+				}
+
 				ent->s.groundEntityNum = ENTITYNUM_NONE;
 			}
+			else if ( !tr.startsolid )
+			{
+				ent->s.groundEntityNum = tr.entityNum;
+			}
+
+			supportChanged[ num ] = false;
 
-			ent->nextPhysicsTime = level.time + PHYSICS_TIME;
+			if ( periodic )
+			{
+				ent->nextPhysicsTime = level.time + PHYSICS_TIME;
+			}
+		}
+
+		if ( supportOf[ num ] != ent->s.groundEntityNum )
+		{
+			G_AddSupport( num, ent->s.groundEntityNum );
 		}
 
 		return;
 	}
 
+	// moving, so it neither rests on anything nor supports anything any more
+	G_RemoveSupport( ent->num() );
+	G_InvalidateSupport( ent );
+
 	// trace a line from the previous position to the current position
 
 	// get current position
@@ -151,6 +315,12 @@ void G_Physics( gentity_t *ent )
 	trap_Trace( &tr, ent->r.currentOrigin, ent->r.mins, ent->r.maxs, origin, ent->num(),
 	            ent->clipmask, 0 );
 
+	// power saving prefers buildables far from the base, so a moved buildable reorders them
+	if ( ent->s.eType == entityType_t::ET_BUILDABLE && !VectorCompare( tr.endpos, ent->r.currentOrigin ) )
+	{
+		G_InvalidateBuildablePowerStates();
+	}
+
 	VectorCopy( tr.endpos, ent->r.currentOrigin );
 
 	if ( tr.startsolid )
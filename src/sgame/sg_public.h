@@ -81,11 +81,14 @@ bool              G_InsideBase(gentity_t *self);
 bool              G_DretchCanDamageEntity( const gentity_t *ent );
 gentity_t         *G_Build( gentity_t *builder, buildable_t buildable, const vec3_t origin, const vec3_t normal, const vec3_t angles, int groundEntityNum );
 bool              G_BuildableInRange( vec3_t origin, float radius, buildable_t buildable );
+bool              G_ArmouryInRange( gentity_t *client );
 gentity_t         *G_GetDeconstructibleBuildable( gentity_t *ent );
 bool              G_DeconstructDead( gentity_t *buildable );
 void              G_DeconstructUnprotected( gentity_t *buildable, gentity_t *ent );
 bool              G_CheckDeconProtectionAndWarn( gentity_t *buildable, gentity_t *player );
 itemBuildError_t  G_CanBuild( gentity_t *ent, buildable_t buildable, int distance, vec3_t origin, vec3_t normal, int *groundEntNum );
+itemBuildError_t  G_CanBuildPreview( gentity_t *ent, buildable_t buildable, vec3_t origin, vec3_t normal, int *groundEntNum );
+void              G_ResetBuildPreviews();
 bool              G_BuildIfValid( gentity_t *ent, buildable_t buildable );
 void              G_SetBuildableAnim(gentity_t *ent, buildableAnimNumber_t animation, bool force);
 void              G_SetIdleBuildableAnim(gentity_t *ent, buildableAnimNumber_t animation);
@@ -101,6 +104,7 @@ void              G_BuildLogSet( buildLog_t *log, gentity_t *ent );
 void              G_BuildLogAuto( gentity_t *actor, gentity_t *buildable, buildFate_t fate );
 void              G_BuildLogRevert( int id );
 void              G_UpdateBuildablePowerStates();
+void              G_InvalidateBuildablePowerStates();
 void              G_BuildableTouchTriggers( gentity_t *ent );
 
 // TODO: Convert these functions to component methods.
@@ -193,13 +197,12 @@ void G_AnnounceStolenBP();
 // sg_momentum.c
 void              G_DecreaseMomentum();
 float             G_AddMomentumGeneric( team_t team, float amount );
-float             G_AddMomentumGenericStep( team_t team, float amount );
 float             G_PredictMomentumForBuilding( gentity_t *buildable );
 float             G_AddMomentumForBuilding( gentity_t *buildable );
 float             G_RemoveMomentumForDecon( gentity_t *buildable, gentity_t *deconner );
-float             G_AddMomentumForKillingStep( gentity_t *victim, gentity_t *attacker, float share );
-float             G_AddMomentumForDestroyingStep( gentity_t *buildable, gentity_t *attacker, float amount );
-void              G_AddMomentumEnd();
+float             G_AddMomentumForKilling( gentity_t *victim, gentity_t *attacker, float share );
+float             G_AddMomentumForDestroying( gentity_t *buildable, gentity_t *attacker, float amount );
+void              G_PublishMomentum();
 
 // sg_main.c
 void              G_InitSpawnQueue( spawnQueue_t *sq );
@@ -219,6 +222,7 @@ void              FindIntermissionPoint();
 void              G_RunThink( gentity_t *ent );
 void              G_AdminMessage( gentity_t *ent, const char *string );
 void              G_LogPrintf( const char *fmt, ... ) PRINTF_LIKE(1);
+void              G_LogFlush();
 void              SendScoreboardMessageToAllClients();
 void              G_Vote( gentity_t *ent, team_t team, bool voting );
 void              G_ResetVote( team_t team );
@@ -260,6 +264,10 @@ void              G_namelog_cleanup();
 
 // sg_physcis.c
 void              G_Physics( gentity_t *ent );
+void              G_ResetSupport();
+void              G_InvalidateSupport( const gentity_t *ent );
+void              G_InvalidateRest( const gentity_t *ent );
+void              G_ForgetSupport( const gentity_t *ent );
 
 // sg_session.c
 void              G_ReadSessionData( gclient_t *client );
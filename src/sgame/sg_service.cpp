@@ -0,0 +1,203 @@
+/*
+===========================================================================
+
+Unvanquished GPL Source Code
+Copyright (C) 2026 Unvanquished Developers
+
+This file is part of the Unvanquished GPL Source Code (Unvanquished Source Code).
+
+Unvanquished is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Unvanquished is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Unvanquished; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+===========================================================================
+*/
+
+#include "common/Common.h"
+#include "sg_service.h"
+#include "Entities.h"
+
+namespace {
+// How far a client may move between two updates before its providers are looked up again.
+constexpr float SERVICE_SLACK = 64.0f;
+
+struct service_t
+{
+	gentity_t *ent;
+	vec3_t    mins, maxs; // padded by SERVICE_SLACK
+};
+
+std::vector<service_t> services;
+std::vector<gentity_t*> occupants[ MAX_GENTITIES ];
+std::vector<gentity_t*> providers[ MAX_CLIENTS ];
+vec3_t providerOrigin[ MAX_CLIENTS ];
+
+bool Overlaps( const gentity_t *client, const vec3_t mins, const vec3_t maxs )
+{
+	return client->r.absmin[ 0 ] <= maxs[ 0 ] && client->r.absmin[ 1 ] <= maxs[ 1 ] && client->r.absmin[ 2 ] <= maxs[ 2 ] &&
+	       client->r.absmax[ 0 ] >= mins[ 0 ] && client->r.absmax[ 1 ] >= mins[ 1 ] && client->r.absmax[ 2 ] >= mins[ 2 ];
+}
+
+bool IsServiceClient( const gentity_t *ent )
+{
+	return ent->inuse && ent->client && ent->r.linked && G_IsPlayableTeam( G_Team( ent ) );
+}
+
+void CollectServices()
+{
+	services.clear();
+
+	for ( int num = MAX_CLIENTS; num < level.num_entities; num++ )
+	{
+		gentity_t *ent = &g_entities[ num ];
+		service_t service;
+
+		if ( !ent->inuse || ent->s.eType != entityType_t::ET_BUILDABLE || !G_ServiceArea( ent, service.mins, service.maxs ) )
+		{
+			continue;
+		}
+
+		service.ent = ent;
+
+		for ( int i = 0; i < 3; i++ )
+		{
+			service.mins[ i ] -= SERVICE_SLACK;
+			service.maxs[ i ] += SERVICE_SLACK;
+		}
+
+		services.push_back( service );
+	}
+}
+
+void FindProviders( const gentity_t *client, std::vector<gentity_t*> &list )
+{
+	list.clear();
+
+	for ( const service_t &service : services )
+	{
+		if ( Overlaps( client, service.mins, service.maxs ) )
+		{
+			list.push_back( service.ent );
+		}
+	}
+}
+}
+
+bool G_ServiceArea( const gentity_t *buildable, vec3_t mins, vec3_t maxs )
+{
+	float radius;
+
+	switch ( buildable->s.modelindex )
+	{
+		case BA_H_MEDISTAT:
+			// players standing on top, including jumping ones but not jetpack campers
+			VectorAdd( buildable->s.origin, buildable->r.mins, mins );
+			VectorAdd( buildable->s.origin, buildable->r.maxs, maxs );
+			mins[ 2 ] += buildable->r.mins[ 2 ] + buildable->r.maxs[ 2 ];
+			maxs[ 2 ] += 32;
+			return true;
+
+		case BA_H_ARMOURY:
+		{
+			// see G_BuildableInRange
+			vec3_t center;
+
+			VectorAdd( buildable->r.mins, buildable->r.maxs, center );
+			VectorMA( buildable->r.currentOrigin, 0.5f, center, center );
+			VectorSet( mins, center[ 0 ] - ENTITY_USE_RANGE, center[ 1 ] - ENTITY_USE_RANGE, center[ 2 ] - ENTITY_USE_RANGE );
+			VectorSet( maxs, center[ 0 ] + ENTITY_USE_RANGE, center[ 1 ] + ENTITY_USE_RANGE, center[ 2 ] + ENTITY_USE_RANGE );
+			return true;
+		}
+
+		default:
+			if ( buildable->buildableTeam != TEAM_ALIENS )
+			{
+				return false;
+			}
+
+			// healing, see FindAlienHealthSource
+			radius = static_cast<float>( BG_Buildable( buildable->s.modelindex )->creepSize );
+
+			if ( buildable->s.modelindex == BA_A_BOOSTER )
+			{
+				radius = std::max( radius, REGEN_BOOSTER_RANGE );
+			}
+			else if ( buildable->s.modelindex == BA_A_OVERMIND || buildable->s.modelindex == BA_A_SPAWN )
+			{
+				radius = std::max( radius, static_cast<float>( CREEP_BASESIZE ) );
+			}
+
+			if ( radius <= 0.0f )
+			{
+				return false;
+			}
+
+			VectorSet( mins, buildable->s.origin[ 0 ] - radius, buildable->s.origin[ 1 ] - radius, buildable->s.origin[ 2 ] - radius );
+			VectorSet( maxs, buildable->s.origin[ 0 ] + radius, buildable->s.origin[ 1 ] + radius, buildable->s.origin[ 2 ] + radius );
+			return true;
+	}
+}
+
+void G_UpdateServiceAreas()
+{
+	for ( const service_t &service : services )
+	{
+		occupants[ service.ent->num() ].clear();
+	}
+
+	for ( int num = 0; num < MAX_CLIENTS; num++ )
+	{
+		providers[ num ].clear();
+	}
+
+	CollectServices();
+
+	for ( int num = 0; num < level.maxclients; num++ )
+	{
+		gentity_t *client = &g_entities[ num ];
+
+		if ( !IsServiceClient( client ) )
+		{
+			// look its providers up once it joins
+			VectorSet( providerOrigin[ num ], FLT_MAX, FLT_MAX, FLT_MAX );
+			continue;
+		}
+
+		FindProviders( client, providers[ num ] );
+		VectorCopy( client->r.currentOrigin, providerOrigin[ num ] );
+
+		for ( gentity_t *provider : providers[ num ] )
+		{
+			occupants[ provider->num() ].push_back( client );
+		}
+	}
+}
+
+const std::vector<gentity_t*> &G_ServiceOccupants( const gentity_t *buildable )
+{
+	return occupants[ buildable->num() ];
+}
+
+const std::vector<gentity_t*> &G_ServiceProviders( const gentity_t *client )
+{
+	int num = client->num();
+
+	// clients also move between frames, look again once they got too far
+	if ( Distance( client->r.currentOrigin, providerOrigin[ num ] ) > SERVICE_SLACK )
+	{
+		FindProviders( client, providers[ num ] );
+		VectorCopy( client->r.currentOrigin, providerOrigin[ num ] );
+	}
+
+	return providers[ num ];
+}
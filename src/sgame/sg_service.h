@@ -0,0 +1,45 @@
+/*
+===========================================================================
+
+Unvanquished GPL Source Code
+Copyright (C) 2026 Unvanquished Developers
+
+This file is part of the Unvanquished GPL Source Code (Unvanquished Source Code).
+
+Unvanquished is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Unvanquished is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Unvanquished; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+===========================================================================
+*/
+
+#ifndef SG_SERVICE_H_
+#define SG_SERVICE_H_
+
+#include "sg_local.h"
+
+// Per-frame assignment of clients to the support buildables (medistations, armouries, boosters
+// and other alien creep sources) whose area of effect may contain them, made once after the
+// clients moved instead of by every buildable and client on its own.
+void G_UpdateServiceAreas();
+
+// Bounds of the area a support buildable serves. Returns false if it serves none.
+bool G_ServiceArea( const gentity_t *buildable, vec3_t mins, vec3_t maxs );
+
+// Clients that may be in buildable's area, and support buildables whose area may contain client,
+// both in entity order. The lists are padded for movement until the next update, so callers
+// still check the exact area and liveness themselves.
+const std::vector<gentity_t*> &G_ServiceOccupants( const gentity_t *buildable );
+const std::vector<gentity_t*> &G_ServiceProviders( const gentity_t *client );
+
+#endif // SG_SERVICE_H_
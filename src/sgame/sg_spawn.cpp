@@ -458,7 +458,7 @@ static bool G_HandleEntityVersions( entityClassDescriptor_t *spawnDescription, g
 			Log::Warn("Entity %s uses a deprecated classtype — use the class ^5%s^* instead", etos( entity ), spawnDescription->replacement );
 		}
 	}
-	entity->classname = BG_strdup( spawnDescription->replacement );
+	G_SetClassname( entity, spawnDescription->replacement );
 	return true;
 }
 
@@ -592,18 +592,16 @@ static bool G_CallSpawnFunction( gentity_t *spawnedEntity )
 =============
 G_NewString
 
-Builds a copy of the string, translating \n to real linefeeds
+Builds an interned copy of the string, translating \n to real linefeeds
 so message texts can be multi-line
 =============
 */
 char *G_NewString( const char *string )
 {
-	char *newb, *new_p;
-	size_t l = strlen( string ) + 1;
+	std::string newString;
+	size_t l = strlen( string );
 
-	newb = (char*) BG_Alloc( l );
-
-	new_p = newb;
+	newString.reserve( l );
 
 	// turn \n into a real linefeed
 	for ( size_t i = 0; i < l; i++ )
@@ -614,20 +612,20 @@ char *G_NewString( const char *string )
 
 			if ( string[ i ] == 'n' )
 			{
-				*new_p++ = '\n';
+				newString += '\n';
 			}
 			else
 			{
-				*new_p++ = '\\';
+				newString += '\\';
 			}
 		}
 		else
 		{
-			*new_p++ = string[ i ];
+			newString += string[ i ];
 		}
 	}
 
-	return newb;
+	return G_InternString( newString.c_str() );
 }
 
 /*
@@ -637,25 +635,21 @@ G_NewTarget
 */
 static gentityCallDefinition_t G_NewCallDefinition( const char *eventKey, const char *string )
 {
-	char *stringPointer;
 	gentityCallDefinition_t newCallDefinition = { nullptr, ON_DEFAULT, nullptr, nullptr, ECA_NOP };
 
-	size_t stringLength = strlen( string ) + 1;
-	if ( stringLength == 1 )
+	if ( !string[ 0 ] )
 		return newCallDefinition;
 
-	stringPointer = (char*) BG_Alloc( stringLength );
-	newCallDefinition.name = stringPointer;
+	const char *separator = strchr( string, ':' );
 
-	for ( size_t i = 0; i < stringLength; i++ )
+	if ( separator )
 	{
-		if ( string[ i ] == ':' && !newCallDefinition.action )
-		{
-			*stringPointer++ = '\0';
-			newCallDefinition.action = stringPointer;
-			continue;
-		}
-		*stringPointer++ = string[ i ];
+		newCallDefinition.name = G_InternString( std::string( string, separator ).c_str() );
+		newCallDefinition.action = G_InternString( separator + 1 );
+	}
+	else
+	{
+		newCallDefinition.name = G_InternString( string );
 	}
 	newCallDefinition.actionType = G_GetCallActionTypeFor( newCallDefinition.action );
 
@@ -861,6 +855,8 @@ static void G_SpawnGEntityFromSpawnVars()
 	                       std::end( spawningEntity->mapEntity.targets ),
 	                       []( char *p ) { return p != nullptr; } );
 
+	G_UpdateEntityIndex( spawningEntity );
+
 	/*
 	 * for backward compatbility, since before targets were used for calling,
 	 * we'll have to copy them over to the called-targets as well for now
@@ -918,29 +914,31 @@ bool G_WarnAboutDeprecatedEntityField( gentity_t *entity, const char *expectedFi
 	return true;
 }
 
+// The whole entity string is tokenised before anything is spawned; keys and
+// values are stored back to back in parsedSpawnChars and level.spawnVars
+// points into it while an entity is being spawned.
+struct parsedEntity_t
+{
+	size_t firstVar;
+	int    numVars;
+};
+
+static std::vector<char>                      parsedSpawnChars;
+static std::vector<std::pair<size_t, size_t>> parsedSpawnVars; // key / value offsets
+static std::vector<parsedEntity_t>            parsedEntities;
+
 /*
 ====================
 G_AddSpawnVarToken
 ====================
 */
-static char *G_AddSpawnVarToken( const char *string )
+static size_t G_AddSpawnVarToken( const char *string )
 {
-	int  l;
-	char *dest;
-
-	l = strlen( string );
-
-	if ( level.numSpawnVarChars + l + 1 > MAX_SPAWN_VARS_CHARS )
-	{
-		Sys::Drop( "G_AddSpawnVarToken: MAX_SPAWN_VARS_CHARS" );
-	}
+	size_t offset = parsedSpawnChars.size();
 
-	dest = level.spawnVarChars + level.numSpawnVarChars;
-	memcpy( dest, string, l + 1 );
+	parsedSpawnChars.insert( parsedSpawnChars.end(), string, string + strlen( string ) + 1 );
 
-	level.numSpawnVarChars += l + 1;
-
-	return dest;
+	return offset;
 }
 
 /*
@@ -948,16 +946,13 @@ static char *G_AddSpawnVarToken( const char *string )
 G_ParseSpawnVars
 
 Parses a brace bounded set of key / value pairs out of the
-level's entity strings into level.spawnVars[]
+level's entity strings into parsedEntities
 
 This does not actually spawn an entity.
 ====================
 */
 static bool G_ParseSpawnVars( const char** entString )
 {
-	level.numSpawnVars = 0;
-	level.numSpawnVarChars = 0;
-
 	const char* entityString = *entString;
 	const char* token;
 
@@ -974,6 +969,9 @@ static bool G_ParseSpawnVars( const char** entString )
 		Sys::Drop( "G_ParseSpawnVars: found %s when expecting {", token );
 	}
 
+	parsedEntity_t entity = { parsedSpawnVars.size(), 0 };
+	size_t firstChar = parsedSpawnChars.size();
+
 	// go through all the key / value pairs
 	while ( 1 )
 	{
@@ -1002,20 +1000,49 @@ static bool G_ParseSpawnVars( const char** entString )
 			Sys::Drop( "G_ParseSpawnVars: closing brace without data" );
 		}
 
-		if ( level.numSpawnVars == MAX_SPAWN_VARS )
+		if ( entity.numVars == MAX_SPAWN_VARS )
 		{
 			Sys::Drop( "G_ParseSpawnVars: MAX_SPAWN_VARS" );
 		}
 
-		level.spawnVars[ level.numSpawnVars ][ 0 ] = G_AddSpawnVarToken( key.c_str() );
-		level.spawnVars[ level.numSpawnVars ][ 1 ] = G_AddSpawnVarToken( token );
-		level.numSpawnVars++;
+		size_t keyOffset = G_AddSpawnVarToken( key.c_str() );
+		size_t valueOffset = G_AddSpawnVarToken( token );
+
+		if ( parsedSpawnChars.size() - firstChar > MAX_SPAWN_VARS_CHARS )
+		{
+			Sys::Drop( "G_ParseSpawnVars: MAX_SPAWN_VARS_CHARS" );
+		}
+
+		parsedSpawnVars.emplace_back( keyOffset, valueOffset );
+		entity.numVars++;
 	}
 
+	parsedEntities.push_back( entity );
+
 	*entString = entityString;
 	return true;
 }
 
+/*
+====================
+G_LoadSpawnVars
+
+Makes a parsed entity the one the G_Spawn*() functions read from
+====================
+*/
+static void G_LoadSpawnVars( const parsedEntity_t &entity )
+{
+	level.numSpawnVars = entity.numVars;
+
+	for ( int i = 0; i < entity.numVars; i++ )
+	{
+		const std::pair<size_t, size_t> &var = parsedSpawnVars[ entity.firstVar + i ];
+
+		level.spawnVars[ i ][ 0 ] = parsedSpawnChars.data() + var.first;
+		level.spawnVars[ i ][ 1 ] = parsedSpawnChars.data() + var.second;
+	}
+}
+
 // The callbacks don't work until BG_InitAllConfigs()
 static void InitDisabledItemCvars()
 {
@@ -1139,11 +1166,11 @@ static void SP_worldspawn()
 
 	g_entities[ ENTITYNUM_WORLD ].s.number = ENTITYNUM_WORLD;
 	g_entities[ ENTITYNUM_WORLD ].r.ownerNum = ENTITYNUM_NONE;
-	g_entities[ ENTITYNUM_WORLD ].classname = BG_strdup( S_WORLDSPAWN );
+	G_SetClassname( &g_entities[ ENTITYNUM_WORLD ], S_WORLDSPAWN );
 
 	g_entities[ ENTITYNUM_NONE ].s.number = ENTITYNUM_NONE;
 	g_entities[ ENTITYNUM_NONE ].r.ownerNum = ENTITYNUM_NONE;
-	g_entities[ ENTITYNUM_NONE ].classname = BG_strdup( "nothing" );
+	G_SetClassname( &g_entities[ ENTITYNUM_NONE ], "nothing" );
 
 	// see if we want a warmup time
 	trap_SetConfigstring( CS_WARMUP, "-1" );
@@ -1158,11 +1185,35 @@ static void SP_worldspawn()
 	level.timelimit = g_timelimit.Get();
 }
 
+/*
+==============
+G_ParseEntitiesFromString
+
+Tokenises the textual entity definitions out of the entstring, to be
+spawned by G_SpawnEntitiesFromString.
+==============
+*/
+void G_ParseEntitiesFromString()
+{
+	parsedSpawnChars.clear();
+	parsedSpawnVars.clear();
+	parsedEntities.clear();
+
+	const char* entityString = CM_EntityString();
+
+	while ( G_ParseSpawnVars( &entityString ) );
+
+	if ( parsedEntities.empty() )
+	{
+		Sys::Drop( "SpawnEntities: no entities" );
+	}
+}
+
 /*
 ==============
 G_SpawnEntitiesFromString
 
-Parses textual entity definitions out of an entstring and spawns gentities.
+Spawns gentities from the definitions parsed by G_ParseEntitiesFromString.
 ==============
 */
 void G_SpawnEntitiesFromString()
@@ -1173,19 +1224,21 @@ void G_SpawnEntitiesFromString()
 	// the worldspawn is not an actual entity, but it still
 	// has a "spawn" function to perform any global setup
 	// needed by a level (setting configstrings or cvars, etc)
-	const char* entityString = CM_EntityString();
-	if ( !G_ParseSpawnVars( &entityString ) )
-	{
-		Sys::Drop( "SpawnEntities: no entities" );
-	}
-
+	G_LoadSpawnVars( parsedEntities[ 0 ] );
 	SP_worldspawn();
 
-	// parse ents
-	while ( G_ParseSpawnVars( &entityString ) )
+	// spawn ents
+	for ( size_t i = 1; i < parsedEntities.size(); i++ )
 	{
+		G_LoadSpawnVars( parsedEntities[ i ] );
 		G_SpawnGEntityFromSpawnVars();
 	}
+
+	// level.spawnVars points into the parsed strings, which are released now
+	level.numSpawnVars = 0;
+	std::vector<char>().swap( parsedSpawnChars );
+	std::vector<std::pair<size_t, size_t>>().swap( parsedSpawnVars );
+	std::vector<parsedEntity_t>().swap( parsedEntities );
 }
 
 void G_SpawnFakeEntities()
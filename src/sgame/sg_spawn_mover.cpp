@@ -67,6 +67,69 @@ struct pushed_t
 
 pushed_t pushed[ MAX_GENTITIES ], *pushed_p;
 
+// entities movers can push, collected at most once per frame by G_PushablesInBox
+static std::vector<int> pushableEntities;
+static int pushableEntitiesTime = -1;
+
+static bool G_IsPushable( const gentity_t *ent )
+{
+	// only push items and players
+	return ent->s.eType == entityType_t::ET_ITEM || ent->s.eType == entityType_t::ET_BUILDABLE ||
+	       ent->s.eType == entityType_t::ET_CORPSE || ent->s.eType == entityType_t::ET_PLAYER ||
+	       ent->physicsObject;
+}
+
+/*
+============
+G_PushablesInBox
+
+Like trap_EntitiesInBox, but only returns linked entities that movers push,
+in entity order. They are a small part of all entities, so they are collected
+once per frame and every mover filters that list instead of walking the world
+sectors with a list the size of MAX_GENTITIES.
+============
+*/
+static void G_PushablesInBox( const vec3_t mins, const vec3_t maxs, std::vector<int> &list )
+{
+	if ( pushableEntitiesTime != level.time )
+	{
+		pushableEntities.clear();
+
+		for ( int num = 0; num < level.num_entities; num++ )
+		{
+			const gentity_t *ent = &g_entities[ num ];
+
+			if ( ent->inuse && G_IsPushable( ent ) )
+			{
+				pushableEntities.push_back( num );
+			}
+		}
+
+		pushableEntitiesTime = level.time;
+	}
+
+	list.clear();
+
+	for ( int num : pushableEntities )
+	{
+		const gentity_t *ent = &g_entities[ num ];
+
+		// the entity may have changed since the list was built
+		if ( !ent->inuse || !ent->r.linked || !G_IsPushable( ent ) )
+		{
+			continue;
+		}
+
+		if ( ent->r.absmin[ 0 ] > maxs[ 0 ] || ent->r.absmin[ 1 ] > maxs[ 1 ] || ent->r.absmin[ 2 ] > maxs[ 2 ] ||
+		     ent->r.absmax[ 0 ] < mins[ 0 ] || ent->r.absmax[ 1 ] < mins[ 1 ] || ent->r.absmax[ 2 ] < mins[ 2 ] )
+		{
+			continue;
+		}
+
+		list.push_back( num );
+	}
+}
+
 /*
 ============
 G_TestEntityPosition
@@ -140,6 +203,40 @@ static void G_RotatePoint( vec3_t point, vec3_t matrix[ 3 ] )
 	point[ 2 ] = DotProduct( matrix[ 2 ], tvec );
 }
 
+/*
+================
+G_RotatedBounds
+
+World bounds of a rotated entity's box, padded by pad
+================
+*/
+static void G_RotatedBounds( const vec3_t origin, const vec3_t angles, const vec3_t mins, const vec3_t maxs,
+                             float pad, vec3_t absmin, vec3_t absmax )
+{
+	vec3_t axis[ 3 ];
+
+	AngleVectors( angles, axis[ 0 ], axis[ 1 ], axis[ 2 ] );
+	VectorInverse( axis[ 1 ] );
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		absmin[ i ] = absmax[ i ] = origin[ i ];
+
+		// extend along every local axis by the projection of its extent
+		for ( int j = 0; j < 3; j++ )
+		{
+			float a = axis[ j ][ i ] * mins[ j ];
+			float b = axis[ j ][ i ] * maxs[ j ];
+
+			absmin[ i ] += std::min( a, b );
+			absmax[ i ] += std::max( a, b );
+		}
+
+		absmin[ i ] -= pad;
+		absmax[ i ] += pad;
+	}
+}
+
 /*
 ==================
 G_TryPushingEntity
@@ -265,40 +362,39 @@ static bool G_TryPushingEntity( gentity_t *check, gentity_t *pusher, vec3_t move
 
 /*
 ============
-G_MoverPush
+G_MoverPushBounds
 
-Objects need to be moved back on a failed push,
-otherwise riders would continue to slide.
-If false is returned, *obstacle will be the blocking entity
+mins/maxs are the bounds at the destination
+totalMins / totalMaxs are the bounds for the entire move
 ============
 */
-static bool G_MoverPush( gentity_t *pusher, vec3_t move, vec3_t amove, gentity_t **obstacle )
+static void G_MoverPushBounds( const gentity_t *pusher, const vec3_t move, const vec3_t amove,
+                               vec3_t mins, vec3_t maxs, vec3_t totalMins, vec3_t totalMaxs )
 {
-	int       i, e;
-	gentity_t *check;
-	vec3_t    mins, maxs;
-	pushed_t  *p;
-	int       entityList[ MAX_GENTITIES ];
-	int       listedEntities;
-	vec3_t    totalMins, totalMaxs;
-
-	*obstacle = nullptr;
+	int i;
 
-	// mins/maxs are the bounds at the destination
-	// totalMins / totalMaxs are the bounds for the entire move
 	if ( pusher->r.currentAngles[ 0 ] || pusher->r.currentAngles[ 1 ] || pusher->r.currentAngles[ 2 ]
 	     || amove[ 0 ] || amove[ 1 ] || amove[ 2 ] )
 	{
-		float radius;
+		vec3_t origin, angles, startMins, startMaxs;
+
+		// Rotate the box itself rather than taking the cube around its bounding sphere. Only the
+		// start and end orientations matter as the move is instant, but allow for the corners
+		// bulging out when rotating between the two, plus the rounding trap_LinkEntity does.
+		float angle = DEG2RAD( fabsf( amove[ 0 ] ) + fabsf( amove[ 1 ] ) + fabsf( amove[ 2 ] ) );
+		float bulge = RadiusFromBounds( pusher->r.mins, pusher->r.maxs ) * ( 1.0f - cosf( std::min( angle, float( M_PI ) ) * 0.5f ) );
 
-		radius = RadiusFromBounds( pusher->r.mins, pusher->r.maxs );
+		VectorAdd( pusher->r.currentOrigin, move, origin );
+		VectorAdd( pusher->r.currentAngles, amove, angles );
+
+		G_RotatedBounds( origin, angles, pusher->r.mins, pusher->r.maxs, bulge + 1.0f, mins, maxs );
+		G_RotatedBounds( pusher->r.currentOrigin, pusher->r.currentAngles, pusher->r.mins, pusher->r.maxs,
+		                 bulge + 1.0f, startMins, startMaxs );
 
 		for ( i = 0; i < 3; i++ )
 		{
-			mins[ i ] = pusher->r.currentOrigin[ i ] + move[ i ] - radius;
-			maxs[ i ] = pusher->r.currentOrigin[ i ] + move[ i ] + radius;
-			totalMins[ i ] = mins[ i ] - move[ i ];
-			totalMaxs[ i ] = maxs[ i ] - move[ i ];
+			totalMins[ i ] = std::min( mins[ i ], startMins[ i ] );
+			totalMaxs[ i ] = std::max( maxs[ i ], startMaxs[ i ] );
 		}
 	}
 	else
@@ -324,30 +420,58 @@ static bool G_MoverPush( gentity_t *pusher, vec3_t move, vec3_t amove, gentity_t
 			}
 		}
 	}
+}
 
-	// unlink the pusher so we don't get it in the entityList
-	trap_UnlinkEntity( pusher );
+/*
+============
+G_MoverPush
 
-	listedEntities = trap_EntitiesInBox( totalMins, totalMaxs, entityList, MAX_GENTITIES );
+Objects need to be moved back on a failed push,
+otherwise riders would continue to slide.
+If false is returned, *obstacle will be the blocking entity
+candidates are the pushable entities around the whole group's move
+============
+*/
+static bool G_MoverPush( gentity_t *pusher, vec3_t move, vec3_t amove, const std::vector<int> &candidates,
+                         gentity_t **obstacle )
+{
+	gentity_t *check;
+	vec3_t    mins, maxs;
+	pushed_t  *p;
+	vec3_t    totalMins, totalMaxs;
+
+	*obstacle = nullptr;
+
+	G_MoverPushBounds( pusher, move, amove, mins, maxs, totalMins, totalMaxs );
 
 	// move the pusher to its final position
 	VectorAdd( pusher->r.currentOrigin, move, pusher->r.currentOrigin );
 	VectorAdd( pusher->r.currentAngles, amove, pusher->r.currentAngles );
 	trap_LinkEntity( pusher );
 
+	G_InvalidateSupport( pusher );
+
 	// see if any solid entities are inside the final position
-	for ( e = 0; e < listedEntities; e++ )
+	for ( int num : candidates )
 	{
-		check = &g_entities[ entityList[ e ] ];
+		check = &g_entities[ num ];
 
-		// only push items and players
-		if ( check->s.eType != entityType_t::ET_ITEM && check->s.eType != entityType_t::ET_BUILDABLE &&
-		     check->s.eType != entityType_t::ET_CORPSE && check->s.eType != entityType_t::ET_PLAYER &&
-		     !check->physicsObject )
+		// a crushed entity may already be gone
+		if ( check == pusher || !check->inuse )
 		{
 			continue;
 		}
 
+		// earlier parts of the group may have pushed it here, or away
+		if ( check->r.absmin[ 0 ] > totalMaxs[ 0 ] || check->r.absmin[ 1 ] > totalMaxs[ 1 ] || check->r.absmin[ 2 ] > totalMaxs[ 2 ] ||
+		     check->r.absmax[ 0 ] < totalMins[ 0 ] || check->r.absmax[ 1 ] < totalMins[ 1 ] || check->r.absmax[ 2 ] < totalMins[ 2 ] )
+		{
+			continue;
+		}
+
+		// the mover passed by, whatever it rests on may have changed
+		G_InvalidateRest( check );
+
 		// if the entity is standing on the pusher, it will definitely be moved
 		if ( check->s.groundEntityNum != pusher->num() )
 		{
@@ -373,6 +497,8 @@ static bool G_MoverPush( gentity_t *pusher, vec3_t move, vec3_t amove, gentity_t
 		// the entity needs to be pushed
 		if ( G_TryPushingEntity( check, pusher, move, amove ) )
 		{
+			// it may carry others that stay stationary, e.g. on a buildable or corpse
+			G_InvalidateSupport( check );
 			continue;
 		}
 
@@ -418,9 +544,12 @@ G_MoverGroup
 */
 static void G_MoverGroup( gentity_t *ent )
 {
+	static std::vector<int> candidates;
 	vec3_t    move, amove;
 	gentity_t *part, *obstacle;
 	vec3_t    origin, angles;
+	vec3_t    groupMins, groupMaxs;
+	bool      moving = false;
 
 	obstacle = nullptr;
 
@@ -429,6 +558,41 @@ static void G_MoverGroup( gentity_t *ent )
 	// if the move is blocked, all moved objects will be backed out
 	pushed_p = pushed;
 
+	// look the entities in the way of the whole group up once
+	for ( part = ent; part; part = part->mapEntity.groupChain )
+	{
+		if ( part->s.pos.trType == trType_t::TR_STATIONARY &&
+		     part->s.apos.trType == trType_t::TR_STATIONARY )
+		{
+			continue;
+		}
+
+		vec3_t mins, maxs, totalMins, totalMaxs;
+
+		BG_EvaluateTrajectory( &part->s.pos, level.time, origin );
+		BG_EvaluateTrajectory( &part->s.apos, level.time, angles );
+		VectorSubtract( origin, part->r.currentOrigin, move );
+		VectorSubtract( angles, part->r.currentAngles, amove );
+		G_MoverPushBounds( part, move, amove, mins, maxs, totalMins, totalMaxs );
+
+		if ( !moving )
+		{
+			VectorCopy( totalMins, groupMins );
+			VectorCopy( totalMaxs, groupMaxs );
+			moving = true;
+		}
+		else
+		{
+			AddPointToBounds( totalMins, groupMins, groupMaxs );
+			AddPointToBounds( totalMaxs, groupMins, groupMaxs );
+		}
+	}
+
+	if ( moving )
+	{
+		G_PushablesInBox( groupMins, groupMaxs, candidates );
+	}
+
 	for ( part = ent; part; part = part->mapEntity.groupChain )
 	{
 		if ( part->s.pos.trType == trType_t::TR_STATIONARY &&
@@ -443,7 +607,7 @@ static void G_MoverGroup( gentity_t *ent )
 		VectorSubtract( origin, part->r.currentOrigin, move );
 		VectorSubtract( angles, part->r.currentAngles, amove );
 
-		if ( !G_MoverPush( part, move, amove, &obstacle ) )
+		if ( !G_MoverPush( part, move, amove, candidates, &obstacle ) )
 		{
 			break; // move was blocked
 		}
@@ -1608,7 +1772,7 @@ static void Think_SpawnNewDoorTrigger( gentity_t *self )
 
 	// create a trigger with this size
 	other = G_NewEntity( NO_CBSE );
-	other->classname = BG_strdup( S_DOOR_SENSOR );
+	G_SetClassname( other, S_DOOR_SENSOR );
 	VectorCopy( mins, other->r.mins );
 	VectorCopy( maxs, other->r.maxs );
 	other->parent = self;
@@ -2094,7 +2258,7 @@ static void SpawnPlatSensor( gentity_t *self )
 	// the middle trigger will be a thin trigger just
 	// above the starting position
 	sensor = G_NewEntity( NO_CBSE );
-	sensor->classname = BG_strdup( S_PLAT_SENSOR );
+	G_SetClassname( sensor, S_PLAT_SENSOR );
 	sensor->touch = Touch_PlatCenterTrigger;
 	sensor->r.contents = CONTENTS_TRIGGER;
 	sensor->parent = self;
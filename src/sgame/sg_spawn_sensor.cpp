@@ -35,6 +35,7 @@ Maryland 20850 USA.
 #include "common/Common.h"
 #include "sg_local.h"
 #include "sg_spawn.h"
+#include "sg_events.h"
 
 //the same as InitTrigger
 static void InitBrushSensor( gentity_t *self )
@@ -163,22 +164,26 @@ static void sensor_start_fireAndForget( gentity_t *self )
 	G_FreeEntity( self );
 }
 
-void SP_sensor_start( gentity_t* )
+static void sensor_start_notify( gentity_t *self, const gameEventData_t& )
+{
+	if ( !self->enabled )
+		return;
+
+	sensor_start_fireAndForget( self );
+}
+
+void SP_sensor_start( gentity_t *self )
 {
 	//self->think = sensor_start_fireAndForget; //gonna reuse that later, when we make sensor_start delayable again (configurable though)
+	G_SubscribeGameEvent( self, gameEvent_t::MATCH_START, sensor_start_notify );
 }
 
 void G_notify_sensor_start()
 {
-	gentity_t *sensor = nullptr;
-
 	if( g_debugEntities.Get() >= 2 )
 		Log::Debug( "Notification of match start.");
 
-	while ((sensor = G_IterateEntitiesOfClass(sensor, S_SENSOR_START)) != nullptr )
-	{
-		sensor_start_fireAndForget(sensor);
-	}
+	G_PublishGameEvent( gameEvent_t::MATCH_START, {} );
 }
 
 /*
@@ -244,29 +249,36 @@ Called when stages change
 */
 void G_notify_sensor_stage( team_t team, int previousStage, int newStage )
 {
-	gentity_t *entities = nullptr;
-
 	if( g_debugEntities.Get() >= 2 )
 		Log::Debug( "Notification of team %i changing stage from %i to %i (0-2).", team, previousStage, newStage );
 
 	if(newStage <= previousStage) //not supporting stage down yet, also no need to fire if stage didn't change at all
 		return;
 
-	while ((entities = G_IterateEntitiesOfClass(entities, S_SENSOR_STAGE)) != nullptr )
+	gameEventData_t data = {};
+	data.team = team;
+	data.previousStage = previousStage;
+	data.newStage = newStage;
+	G_PublishGameEvent( gameEvent_t::STAGE_CHANGE, data );
+}
+
+static void sensor_stage_notify( gentity_t *self, const gameEventData_t &data )
+{
+	if ( !self->enabled )
+		return;
+
+	if (((!self->mapEntity.conditions.stage || data.newStage == self->mapEntity.conditions.stage)
+			&& (!self->mapEntity.conditions.team || data.team == self->mapEntity.conditions.team))
+			== !self->mapEntity.conditions.negated)
 	{
-		if (((!entities->mapEntity.conditions.stage || newStage == entities->mapEntity.conditions.stage)
-				&& (!entities->mapEntity.conditions.team || team == entities->mapEntity.conditions.team))
-				== !entities->mapEntity.conditions.negated)
-		{
-			G_FireEntity(entities, entities);
-			// remove this entity now to prevent subsequent activation
-			// TODO: when implementing stage down triggers, we will probably
-			// want to keep the entity forever, and remove this line
-			// comparison to tremulous: trigger_stage could be fired more than
-			// once by not specifying a team (thus, it could be fired twice - once for each team)
-			// but there is no known tremulous map doing this
-			G_FreeEntity( entities );
-		}
+		G_FireEntity(self, self);
+		// remove this entity now to prevent subsequent activation
+		// TODO: when implementing stage down triggers, we will probably
+		// want to keep the entity forever, and remove this line
+		// comparison to tremulous: trigger_stage could be fired more than
+		// once by not specifying a team (thus, it could be fired twice - once for each team)
+		// but there is no known tremulous map doing this
+		G_FreeEntity( self );
 	}
 }
 
@@ -280,6 +292,8 @@ void SP_sensor_stage( gentity_t *self )
 	self->reset = sensor_reset;
 
 	self->r.svFlags = SVF_NOCLIENT;
+
+	G_SubscribeGameEvent( self, gameEvent_t::STAGE_CHANGE, sensor_stage_notify );
 }
 
 /*
@@ -292,18 +306,22 @@ sensor_end
 
 void G_notify_sensor_end( team_t winningTeam )
 {
-	gentity_t *entity = nullptr;
-
 	if( g_debugEntities.Get() >= 2 )
 		Log::Debug( "Notification of game end. Winning team %i.", winningTeam );
 
-	while ((entity = G_IterateEntitiesOfClass(entity, S_SENSOR_END)) != nullptr )
-	{
-		if ((winningTeam == entity->mapEntity.conditions.team) == !entity->mapEntity.conditions.negated)
-			G_FireEntity(entity, entity);
-	}
+	gameEventData_t data = {};
+	data.team = winningTeam;
+	G_PublishGameEvent( gameEvent_t::MATCH_END, data );
 }
 
+static void sensor_end_notify( gentity_t *self, const gameEventData_t &data )
+{
+	if ( !self->enabled )
+		return;
+
+	if ((data.team == self->mapEntity.conditions.team) == !self->mapEntity.conditions.negated)
+		G_FireEntity(self, self);
+}
 
 void SP_sensor_end( gentity_t *self )
 {
@@ -315,6 +333,8 @@ void SP_sensor_end( gentity_t *self )
 	self->reset = sensor_reset;
 
 	self->r.svFlags = SVF_NOCLIENT;
+
+	G_SubscribeGameEvent( self, gameEvent_t::MATCH_END, sensor_end_notify );
 }
 
 /*
@@ -552,6 +572,18 @@ sensor_support
 =================================================================================
 */
 
+/*
+ * The support sensors fire every SENSOR_POLL_PERIOD while the main buildables they
+ * watch are active, and stop thinking while they are not.
+ */
+static void sensor_support_wake( gentity_t *self, const gameEventData_t& )
+{
+	if ( !self->nextthink )
+	{
+		self->nextthink = level.time;
+	}
+}
+
 static void sensor_support_think( gentity_t *self )
 {
 	if(!self->enabled)
@@ -582,9 +614,11 @@ static void sensor_support_think( gentity_t *self )
 	}
 
 	if(powered)
+	{
 		G_FireEntity( self, nullptr );
-
-	self->nextthink = level.time + SENSOR_POLL_PERIOD;
+		self->nextthink = level.time + SENSOR_POLL_PERIOD;
+	}
+	// otherwise sleep until a main buildable changes its state, see sensor_support_wake
 }
 
 static void sensor_support_reset( gentity_t *self )
@@ -598,6 +632,8 @@ void SP_sensor_support( gentity_t *self )
 {
 	self->think = sensor_support_think;
 	self->reset = sensor_support_reset;
+
+	G_SubscribeGameEvent( self, gameEvent_t::MAIN_BUILDABLE_STATE, sensor_support_wake );
 }
 
 /*
@@ -619,16 +655,20 @@ static void sensor_power_think( gentity_t *self )
 
 	bool powered = (G_ActiveReactor() != nullptr);
 
-	if (powered)
+	if(powered)
+	{
 		G_FireEntity( self, nullptr );
-
-	self->nextthink = level.time + SENSOR_POLL_PERIOD;
+		self->nextthink = level.time + SENSOR_POLL_PERIOD;
+	}
+	// otherwise sleep until a main buildable changes its state, see sensor_support_wake
 }
 
 void SP_sensor_power( gentity_t *self )
 {
 	self->think = sensor_power_think;
 	self->reset = sensor_support_reset;
+
+	G_SubscribeGameEvent( self, gameEvent_t::MAIN_BUILDABLE_STATE, sensor_support_wake );
 }
 
 /*
@@ -651,13 +691,17 @@ static void sensor_creep_think( gentity_t *self )
 	bool powered = (G_ActiveOvermind() != nullptr);
 
 	if(powered)
+	{
 		G_FireEntity( self, nullptr );
-
-	self->nextthink = level.time + SENSOR_POLL_PERIOD;
+		self->nextthink = level.time + SENSOR_POLL_PERIOD;
+	}
+	// otherwise sleep until a main buildable changes its state, see sensor_support_wake
 }
 
 void SP_sensor_creep( gentity_t *self )
 {
 	self->think = sensor_creep_think;
 	self->reset = sensor_support_reset;
+
+	G_SubscribeGameEvent( self, gameEvent_t::MAIN_BUILDABLE_STATE, sensor_support_wake );
 }
@@ -364,6 +364,14 @@ struct clientPersistant_t
 	int      floodDemerits;
 	int      floodTime;
 
+	// command rate limiting and accounting, see G_CommandRateLimited
+	float    cmdTokens;
+	int      cmdTokenTime;
+	int      cmdWarnTime;
+	int      cmdCount;
+	int      cmdDropped;
+	int64_t  cmdTimeUs;
+
 	vec3_t   lastDeathLocation;
 	char     guid[ 33 ];
 	addr_t   ip;
@@ -547,6 +555,7 @@ struct level_locals_t
 	int              timelimit; //time in minutes
 
 	fileHandle_t     logFile;
+	fileHandle_t     logJSONFile;
 	fileHandle_t     logGameplayFile;
 
 	// store latched cvars here that we want to get at often
@@ -579,8 +588,6 @@ struct level_locals_t
 	bool spawning; // the G_Spawn*() functions are valid
 	int      numSpawnVars;
 	char     *spawnVars[ MAX_SPAWN_VARS ][ 2 ]; // key / value pairs
-	int      numSpawnVarChars;
-	char     spawnVarChars[ MAX_SPAWN_VARS_CHARS ];
 
 	// intermission state
 	int intermissionQueued; // intermission was qualified, but
@@ -664,6 +671,7 @@ struct level_locals_t
 		spawnQueue_t     spawnQueue;
 		bool             locked;
 		float            momentum;
+		float            publishedMomentum; // what clients and sensors last saw, see G_PublishMomentum
 		int              layoutBuildPoints;
 		int              botFillTeamSize;
 		int              botFillSkillLevel;
@@ -681,11 +689,17 @@ struct level_locals_t
 	} pmoveParams;
 };
 
+// command costs for the per-client token bucket
+#define CMD_COST_DEFAULT 1
+#define CMD_COST_MEDIUM  2
+#define CMD_COST_HEAVY   4
+
 struct commands_t
 {
 	const char *cmdName;
 	int        cmdFlags;
 	void      ( *cmdHandler )( gentity_t *ent );
+	int        cmdCost; // tokens taken from the client's command budget
 };
 
 struct zap_t
@@ -700,6 +714,8 @@ struct zap_t
 	int       timeToLive;
 
 	gentity_t *effectChannel;
+	bool      effectChanged; // the targets changed since the effect was last sent
+	vec3_t    effectOrigin;
 };
 
 #endif // SG_STRUCT_H_
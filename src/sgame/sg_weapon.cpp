@@ -31,6 +31,10 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "sg_local.h"
 #include "Entities.h"
 #include "CBSE.h"
+#include "sg_cm_world.h"
+
+#include <chrono>
+#include <unordered_map>
 
 static void SendHitEvent( gentity_t *attacker, gentity_t *target, glm::vec3 const& origin, glm::vec3 const&  normal, entity_event_t evType );
 
@@ -587,7 +591,7 @@ SHOTGUN
 Keep this in sync with ShotgunPattern in CGAME!
 ================
 */
-static void ShotgunPattern( glm::vec3 const& origin, glm::vec3 const& origin2, int seed, gentity_t *self )
+static void ShotgunPelletEnds( glm::vec3 const& origin, glm::vec3 const& origin2, int seed, std::vector<glm::vec3> &ends )
 {
 	// derive the right and up vectors from the forward vector, because
 	// the client won't have any other information
@@ -597,6 +601,8 @@ static void ShotgunPattern( glm::vec3 const& origin, glm::vec3 const& origin2, i
 	// FIXME: the cross product of forward and right is DOWN not up!
 	glm::vec3 up = glm::cross( forward, right );
 
+	ends.clear();
+
 	// generate the "random" spread pattern
 	for ( int i = 0; i < SHOTGUN_PELLETS; i++ )
 	{
@@ -610,10 +616,42 @@ static void ShotgunPattern( glm::vec3 const& origin, glm::vec3 const& origin2, i
 		end += r * right;
 		end += u * up;
 
-		trace_t tr;
-		trap_Trace( &tr, origin, glm::vec3(), glm::vec3(), end, self->s.number, MASK_SHOT, 0 );
+		ends.push_back( end );
+	}
+}
+
+static void ShotgunPattern( glm::vec3 const& origin, glm::vec3 const& origin2, int seed, gentity_t *self )
+{
+	static std::vector<glm::vec3> ends;
+	static std::vector<trace_t>   traces;
+
+	glm::vec3 forward = glm::normalize( origin2 );
+
+	ShotgunPelletEnds( origin, origin2, seed, ends );
+	traces.resize( ends.size() );
+
+	int pellets = static_cast<int>( ends.size() );
+
+	// trace the pellets together, they share the entities in the cone
+	G_CM_TraceVolley( traces.data(), pellets, GLM4READ( origin ), nullptr, nullptr, ends.data(),
+	                  self->s.number, MASK_SHOT, 0, traceType_t::TT_AABB );
+
+	for ( int i = 0; i < pellets; i++ )
+	{
+		const trace_t &tr = traces[ i ];
+		int changes = G_CM_WorldChanges();
+		int contents = g_entities[ tr.entityNum ].r.contents;
+
 		g_entities[ tr.entityNum ].Damage( (float)SHOTGUN_DMG, self, VEC2GLM( tr.endpos ),
 		                                   forward, 0, MOD_SHOTGUN );
+
+		// a kill can take its victim out of the way of the remaining pellets
+		if ( i + 1 < pellets &&
+		     ( changes != G_CM_WorldChanges() || contents != g_entities[ tr.entityNum ].r.contents ) )
+		{
+			G_CM_TraceVolley( &traces[ i + 1 ], pellets - i - 1, GLM4READ( origin ), nullptr, nullptr,
+			                  &ends[ i + 1 ], self->s.number, MASK_SHOT, 0, traceType_t::TT_AABB );
+		}
 	}
 }
 
@@ -638,6 +676,93 @@ static void FireShotgun( gentity_t *self ) //TODO merge with FireBullet
 	G_UnlaggedOff();
 }
 
+static bool SameTrace( const trace_t &a, const trace_t &b )
+{
+	return a.allsolid == b.allsolid && a.startsolid == b.startsolid && a.fraction == b.fraction &&
+	       VectorCompare( a.endpos, b.endpos ) && VectorCompare( a.plane.normal, b.plane.normal ) &&
+	       a.plane.dist == b.plane.dist && a.surfaceFlags == b.surfaceFlags && a.contents == b.contents &&
+	       a.entityNum == b.entityNum;
+}
+
+class ShotgunBenchCmd : public Cmd::StaticCmd
+{
+public:
+	ShotgunBenchCmd() : StaticCmd( "shotgunBench", Cmd::SGAME_VM, "time shotgun volleys from every player's view, traced pellet by pellet and together" ) {}
+	void Run( const Cmd::Args& args ) const override
+	{
+		int volleys = 1000;
+
+		if ( args.Argc() > 1 && ( !Str::ParseInt( volleys, args.Argv( 1 ) ) || volleys <= 0 ) )
+		{
+			PrintUsage( args, "[volleys]" );
+			return;
+		}
+
+		std::vector<glm::vec3> ends;
+		std::vector<trace_t>   single, together;
+		std::chrono::nanoseconds singleTime{ 0 }, togetherTime{ 0 };
+		int shots = 0, mismatches = 0;
+
+		for ( int clientNum = 0; clientNum < level.maxclients; clientNum++ )
+		{
+			gentity_t *ent = &g_entities[ clientNum ];
+
+			if ( !ent->inuse || !ent->client || !G_IsPlayableTeam( G_Team( ent ) ) )
+			{
+				continue;
+			}
+
+			glm::vec3 forward;
+			AngleVectors( VEC2GLM( ent->client->ps.viewangles ), &forward, nullptr, nullptr );
+			glm::vec3 muzzle = G_CalcMuzzlePoint( ent, forward );
+
+			for ( int seed = 0; seed < volleys; seed++ )
+			{
+				ShotgunPelletEnds( muzzle, forward, seed & 0xff, ends );
+
+				int pellets = static_cast<int>( ends.size() );
+				single.resize( pellets );
+				together.resize( pellets );
+
+				auto start = std::chrono::steady_clock::now();
+
+				for ( int i = 0; i < pellets; i++ )
+				{
+					trap_Trace( &single[ i ], muzzle, glm::vec3(), glm::vec3(), ends[ i ], ent->s.number, MASK_SHOT, 0 );
+				}
+
+				auto middle = std::chrono::steady_clock::now();
+
+				G_CM_TraceVolley( together.data(), pellets, GLM4READ( muzzle ), nullptr, nullptr, ends.data(),
+				                  ent->s.number, MASK_SHOT, 0, traceType_t::TT_AABB );
+
+				auto end = std::chrono::steady_clock::now();
+
+				singleTime += middle - start;
+				togetherTime += end - middle;
+				shots += pellets;
+
+				for ( int i = 0; i < pellets; i++ )
+				{
+					mismatches += !SameTrace( single[ i ], together[ i ] );
+				}
+			}
+		}
+
+		if ( !shots )
+		{
+			Print( "no players to shoot from" );
+			return;
+		}
+
+		Print( "pellets:    %d", shots );
+		Print( "one by one: %.3f ms, %.2f µs per pellet", singleTime.count() / 1.0e6, singleTime.count() / 1.0e3 / shots );
+		Print( "volleys:    %.3f ms, %.2f µs per pellet", togetherTime.count() / 1.0e6, togetherTime.count() / 1.0e3 / shots );
+		Print( "mismatches: %d", mismatches );
+	}
+};
+static ShotgunBenchCmd shotgunBenchCmdRegistration;
+
 /*
 ======================================================================
 
@@ -981,6 +1106,53 @@ LEVEL2
 
 static zap_t zaps[ MAX_ZAPS ];
 
+/*
+Line of sight between chain nodes, remembered for the rest of the frame so that
+several marauders zapping into the same cluster don't trace the same pairs again.
+*/
+struct zapSight_t
+{
+	glm::vec3 from, to;
+	bool      visible;
+};
+
+static std::unordered_map<int, zapSight_t> zapSights;
+static int zapSightsTime = -1;
+
+static bool ZapChainVisible( const gentity_t *source, const glm::vec3 &origin, const gentity_t *enemy )
+{
+	glm::vec3 target = VEC2GLM( enemy->s.origin );
+
+	if ( zapSightsTime != level.time )
+	{
+		zapSights.clear();
+		zapSightsTime = level.time;
+	}
+
+	int key = source->num() * MAX_GENTITIES + enemy->num();
+	auto it = zapSights.find( key );
+
+	// either end may have moved since, e.g. between two client commands
+	if ( it != zapSights.end() && it->second.from == origin && it->second.to == target )
+	{
+		return it->second.visible;
+	}
+
+	// world-LOS check: trace against the world, ignoring other BODY entities
+	trace_t tr;
+	trap_Trace( &tr, origin, glm::vec3(), glm::vec3(), target, source->s.number, CONTENTS_SOLID, 0 );
+
+	bool visible = tr.entityNum == ENTITYNUM_NONE;
+	zapSights[ key ] = { origin, target, visible };
+
+	return visible;
+}
+
+/*
+The candidates come from the engine's sector query. Its order decides which targets
+get chained when there are more than LEVEL2_AREAZAP_MAX_TARGETS, so it is kept as is;
+cheap checks go first and only the remaining candidates are traced.
+*/
 static void FindZapChainTargets( zap_t *zap )
 {
 	gentity_t *ent = zap->targets[ 0 ]; // the source
@@ -1003,20 +1175,19 @@ static void FindZapChainTargets( zap_t *zap )
 			continue;
 		}
 
+		//TODO: implement support for map-entities
+		if ( !enemy->client && enemy->s.eType != entityType_t::ET_BUILDABLE )
+		{
+			continue;
+		}
+
 		float distance = glm::distance( origin, VEC2GLM( enemy->s.origin ) );
 
-		//TODO: implement support for map-entities
 		if ( G_Team( enemy ) == TEAM_HUMANS
-				&& ( enemy->client || enemy->s.eType == entityType_t::ET_BUILDABLE )
-				&& Entities::IsAlive( enemy )
-				&& distance <= LEVEL2_AREAZAP_CHAIN_RANGE )
+				&& distance <= LEVEL2_AREAZAP_CHAIN_RANGE
+				&& Entities::IsAlive( enemy ) )
 		{
-			// world-LOS check: trace against the world, ignoring other BODY entities
-			trace_t tr;
-			trap_Trace( &tr, origin, glm::vec3(), glm::vec3(), VEC2GLM( enemy->s.origin ),
-			            ent->s.number, CONTENTS_SOLID, 0 );
-
-			if ( tr.entityNum == ENTITYNUM_NONE )
+			if ( ZapChainVisible( ent, origin, enemy ) )
 			{
 				zap->targets[ zap->numTargets ] = enemy;
 				zap->distances[ zap->numTargets ] = distance;
@@ -1050,6 +1221,9 @@ static void UpdateZapEffect( zap_t *zap, const glm::vec3 &origin )
 
 	G_SetOrigin( zap->effectChannel, origin );
 	trap_LinkEntity( zap->effectChannel );
+
+	zap->effectChanged = false;
+	VectorCopy( GLM4READ( origin ), zap->effectOrigin );
 }
 
 static void CreateNewZap( gentity_t *creator, const glm::vec3 &muzzle,
@@ -1091,7 +1265,7 @@ static void CreateNewZap( gentity_t *creator, const glm::vec3 &muzzle,
 
 		zap->effectChannel = G_NewEntity( NO_CBSE );
 		zap->effectChannel->s.eType = entityType_t::ET_LEV2_ZAP_CHAIN;
-		zap->effectChannel->classname = BG_strdup( "lev2zapchain" );
+		G_SetClassname( zap->effectChannel, "lev2zapchain" );
 		UpdateZapEffect( zap, muzzle );
 
 		return;
@@ -1130,6 +1304,7 @@ void G_UpdateZaps( int msec )
 			if ( !zap->targets[ j ]->inuse )
 			{
 				zap->targets[ j-- ] = zap->targets[ --zap->numTargets ];
+				zap->effectChanged = true;
 			}
 		}
 
@@ -1137,7 +1312,11 @@ void G_UpdateZaps( int msec )
 		AngleVectors( VEC2GLM( zap->creator->client->ps.viewangles ), &attackerForward, nullptr, nullptr );
 		glm::vec3 attackerMuzzle = G_CalcMuzzlePoint( zap->creator, attackerForward );
 
-		UpdateZapEffect( zap, attackerMuzzle );
+		// only repack and relink the effect when it changed
+		if ( zap->effectChanged || attackerMuzzle != VEC2GLM( zap->effectOrigin ) )
+		{
+			UpdateZapEffect( zap, attackerMuzzle );
+		}
 	}
 }
 
@@ -1174,6 +1353,7 @@ void G_ClearPlayerZapEffects( gentity_t *player )
 			if ( zap->targets[ j ] == player )
 			{
 				zap->targets[ j-- ] = zap->targets[ --zap->numTargets ];
+				zap->effectChanged = true;
 			}
 		}
 	}
@@ -32,7 +32,9 @@ Maryland 20850 USA.
 ===========================================================================
 */
 
-#include <list>
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
 
 #include "common/Common.h"
 #include "register_lua_extensions.h"
@@ -42,48 +44,189 @@ namespace Lua {
 
 namespace {
 
+Cvar::Range<Cvar::Cvar<int>> lua_timerInstructionLimit(
+	VM_STRING_PREFIX "lua_timerInstructionLimit",
+	"maximum number of Lua instructions a timer callback may run, 0 for no limit",
+	Cvar::NONE, 10000000, 0, 1000000000 );
+Cvar::Range<Cvar::Cvar<int>> lua_timerTimeLimit(
+	VM_STRING_PREFIX "lua_timerTimeLimit",
+	"maximum milliseconds a timer callback may run, 0 for no limit",
+	Cvar::NONE, 100, 0, 10000 );
+Cvar::Range<Cvar::Cvar<int>> lua_timerFrameTimeLimit(
+	VM_STRING_PREFIX "lua_timerFrameTimeLimit",
+	"milliseconds after which due timer callbacks are postponed to the next frame, 0 for no limit",
+	Cvar::NONE, 50, 0, 10000 );
+
+using Clock = std::chrono::steady_clock;
+
+// how many instructions run between two checks of the budget
+constexpr int HOOK_INSTRUCTION_INTERVAL = 1000;
+
+// The budget of the callback that is currently running, checked by BudgetHook.
+struct
+{
+	int instructionLimit;
+	int instructions;
+	bool hasDeadline;
+	Clock::time_point deadline;
+	bool exceeded;
+} budget;
+
+void BudgetHook( lua_State* L, lua_Debug* )
+{
+	budget.instructions += HOOK_INSTRUCTION_INTERVAL;
+
+	if ( ( budget.instructionLimit && budget.instructions > budget.instructionLimit ) ||
+	     ( budget.hasDeadline && Clock::now() > budget.deadline ) )
+	{
+		budget.exceeded = true;
+		luaL_error( L, "timer callback exceeded its CPU budget" );
+	}
+}
+
 class Timer
 {
    public:
 	void Add( int delayMs, int callbackRef, lua_State* L )
 	{
-		events.push_back( { delayMs, callbackRef, L } );
+		// Timers added before the first update are relative to the time of that update.
+		events.push_back( { lastTime + delayMs, nextSequence++, callbackRef, L } );
+		std::push_heap( events.begin(), events.end(), Later );
 	}
 
 	void RunUpdate( int time )
 	{
-		int dtMs = time - lastTime;
-		lastTime = time;
-
-		auto it = events.begin();
-		while ( it != events.end() )
+		if ( !started )
 		{
-			it->delayMs -= dtMs;
-			if ( it->delayMs <= 0 )
+			for ( TimerEvent& event : events )
 			{
-				lua_rawgeti( it->L, LUA_REGISTRYINDEX, it->callbackRef );
-				luaL_unref( it->L, LUA_REGISTRYINDEX, it->callbackRef );
-				if ( lua_pcall( it->L, 0, 0, 0 ) != 0 )
-					Log::Warn( "Could not run lua timer callback: %s", lua_tostring( it->L, -1 ) );
-				it = events.erase( it );
+				event.dueTime += time - lastTime;
 			}
-			else
+			started = true;
+		}
+		lastTime = time;
+
+		Clock::time_point frameStart = Clock::now();
+		int frameLimitMs = lua_timerFrameTimeLimit.Get();
+
+		// Callbacks may add timers, those with no delay still run in this update.
+		while ( !events.empty() && events.front().dueTime <= time )
+		{
+			if ( frameLimitMs && Clock::now() - frameStart > std::chrono::milliseconds( frameLimitMs ) )
 			{
-				++it;
+				// leave the remaining callbacks for the next update
+				break;
 			}
+
+			std::pop_heap( events.begin(), events.end(), Later );
+			TimerEvent event = events.back();
+			events.pop_back();
+
+			Run( event );
 		}
 	}
 
+	std::vector<TimerStats> GetStats() const
+	{
+		std::vector<TimerStats> result;
+
+		for ( const auto& stats : scriptStats )
+		{
+			result.push_back( stats.second );
+		}
+
+		std::sort( result.begin(), result.end(), []( const TimerStats& a, const TimerStats& b ) {
+			return a.totalUs > b.totalUs;
+		} );
+
+		return result;
+	}
+
    private:
 	struct TimerEvent
 	{
-		int delayMs;
+		int dueTime;
+		int sequence;
 		int callbackRef;
 		lua_State* L;
 	};
 
-	int lastTime;
-	std::list<TimerEvent> events;
+	// the heap keeps the earliest timer in front, ties run in the order they were added
+	static bool Later( const TimerEvent& a, const TimerEvent& b )
+	{
+		if ( a.dueTime != b.dueTime )
+		{
+			return a.dueTime > b.dueTime;
+		}
+		return a.sequence > b.sequence;
+	}
+
+	void Run( const TimerEvent& event )
+	{
+		lua_State* L = event.L;
+
+		lua_rawgeti( L, LUA_REGISTRYINDEX, event.callbackRef );
+		luaL_unref( L, LUA_REGISTRYINDEX, event.callbackRef );
+
+		// account the time to the script that defined the callback
+		TimerStats* stats = nullptr;
+		if ( lua_isfunction( L, -1 ) )
+		{
+			lua_Debug info;
+			lua_pushvalue( L, -1 );
+			lua_getinfo( L, ">S", &info );
+			stats = &scriptStats[ info.short_src ];
+			stats->script = info.short_src;
+		}
+
+		int timeLimitMs = lua_timerTimeLimit.Get();
+		Clock::time_point start = Clock::now();
+
+		budget.instructionLimit = lua_timerInstructionLimit.Get();
+		budget.instructions = 0;
+		budget.hasDeadline = timeLimitMs > 0;
+		budget.deadline = start + std::chrono::milliseconds( timeLimitMs );
+		budget.exceeded = false;
+
+		bool limited = budget.instructionLimit || budget.hasDeadline;
+		if ( limited )
+		{
+			lua_sethook( L, BudgetHook, LUA_MASKCOUNT, HOOK_INSTRUCTION_INTERVAL );
+		}
+
+		if ( lua_pcall( L, 0, 0, 0 ) != 0 )
+		{
+			Log::Warn( "Could not run lua timer callback: %s", lua_tostring( L, -1 ) );
+			lua_pop( L, 1 );
+		}
+
+		if ( limited )
+		{
+			lua_sethook( L, nullptr, 0, 0 );
+		}
+
+		int elapsedUs = static_cast<int>(
+			std::chrono::duration_cast<std::chrono::microseconds>( Clock::now() - start ).count() );
+
+		if ( !stats )
+		{
+			return;
+		}
+
+		stats->calls++;
+		stats->totalUs += elapsedUs;
+		stats->maxUs = std::max( stats->maxUs, elapsedUs );
+		if ( budget.exceeded )
+		{
+			stats->aborted++;
+		}
+	}
+
+	int lastTime = 0;
+	bool started = false;
+	int nextSequence = 0;
+	std::vector<TimerEvent> events;
+	std::unordered_map<std::string, TimerStats> scriptStats;
 };
 
 static Timer timer;
@@ -91,6 +234,8 @@ static Timer timer;
 int Timer_add( lua_State* L )
 {
 	int delayMs = luaL_checkinteger( L, 1 );
+	luaL_checktype( L, 2, LUA_TFUNCTION );
+	lua_settop( L, 2 );
 	int ref = luaL_ref( L, LUA_REGISTRYINDEX );
 	timer.Add( delayMs, ref, L );
 	return 0;
@@ -114,5 +259,10 @@ void UpdateTimers( int time )
 	timer.RunUpdate( time );
 }
 
+std::vector<TimerStats> GetTimerStats()
+{
+	return timer.GetStats();
+}
+
 }  // namespace Lua
 }  // namespace Shared
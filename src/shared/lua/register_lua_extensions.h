@@ -45,6 +45,18 @@ void RegisterTimer(lua_State* L);
 
 void UpdateTimers(int time);
 
+// CPU time spent in the timer callbacks of one script
+struct TimerStats
+{
+	std::string script;
+	int calls = 0;
+	int aborted = 0;   // callbacks stopped for exceeding their budget
+	int64_t totalUs = 0;
+	int maxUs = 0;
+};
+
+std::vector<TimerStats> GetTimerStats();
+
 
 }  // namespace Lua
 }  // namespace Shared
@@ -324,6 +324,7 @@ def load_general(definitions):
 
     common_entity_attributes = []
     mandatory_components = []
+    pool_chunk_size = 64
 
     if 'mandatory_components' in definitions:
         mandatory_components += definitions['mandatory_components']
@@ -332,8 +333,13 @@ def load_general(definitions):
         for attrib in definitions['common_entity_attributes']:
             common_entity_attributes.append(CommonAttribute(attrib['name'], attrib['type']))
 
-    return namedtuple('general', ['common_entity_attributes', 'mandatory_components']) \
-        (common_entity_attributes, mandatory_components)
+    if 'pool_chunk_size' in definitions:
+        pool_chunk_size = int(definitions['pool_chunk_size'])
+        if pool_chunk_size <= 0:
+            raise Exception("pool_chunk_size must be positive.")
+
+    return namedtuple('general', ['common_entity_attributes', 'mandatory_components', 'pool_chunk_size']) \
+        (common_entity_attributes, mandatory_components, pool_chunk_size)
 
 def load_messages(definitions):
     if definitions is None:
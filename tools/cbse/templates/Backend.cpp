@@ -43,6 +43,9 @@
  */
 
 #include "{{files['entities']}}"
+#include <algorithm>
+#include <functional>
+#include <new>
 #include <tuple>
 
 #define myoffsetof(st, m) static_cast<int>((size_t)(&((st *)1)->m))-1
@@ -73,6 +76,95 @@ bool Entity::SendMessage(EntityMessage msg, const void* data) {
 	return false;
 }
 
+// //////////// //
+// Entity pools //
+// //////////// //
+
+EntityPool::EntityPool(const char* name, size_t objectSize, size_t chunkCapacity)
+	: chunkUsed(0), freeList(nullptr), stats()
+{
+	//* Slots must be able to hold a free list link and keep every slot aligned.
+	const size_t alignment = alignof(std::max_align_t);
+	slotSize = std::max(objectSize, sizeof(FreeSlot));
+	slotSize = (slotSize + alignment - 1) / alignment * alignment;
+
+	stats.name = name;
+	stats.objectSize = objectSize;
+	stats.chunkCapacity = chunkCapacity;
+}
+
+EntityPool::~EntityPool() {
+	for (char* chunk : chunks) {
+		::operator delete(chunk);
+	}
+}
+
+void* EntityPool::Allocate(size_t size) {
+	void* ptr;
+
+	stats.allocations++;
+
+	if (size > stats.objectSize) {
+		//* A type deriving from the entity does not fit in a slot.
+		stats.overflows++;
+		ptr = ::operator new(size);
+	} else if (freeList) {
+		stats.recycled++;
+		ptr = freeList;
+		freeList = freeList->next;
+	} else {
+		if (chunks.empty() || chunkUsed == stats.chunkCapacity) {
+			chunks.push_back(static_cast<char*>(::operator new(slotSize * stats.chunkCapacity)));
+			chunkUsed = 0;
+			stats.chunks++;
+		}
+		ptr = chunks.back() + chunkUsed * slotSize;
+		chunkUsed++;
+	}
+
+	stats.live++;
+	stats.peak = std::max(stats.peak, stats.live);
+
+	return ptr;
+}
+
+void EntityPool::Free(void* ptr) {
+	if (!ptr) {
+		return;
+	}
+
+	stats.live--;
+
+	if (!Owns(ptr)) {
+		::operator delete(ptr);
+		return;
+	}
+
+	FreeSlot* slot = static_cast<FreeSlot*>(ptr);
+	slot->next = freeList;
+	freeList = slot;
+}
+
+bool EntityPool::Owns(const void* ptr) const {
+	std::less<const char*> less;
+	const char* p = static_cast<const char*>(ptr);
+
+	for (const char* chunk : chunks) {
+		if (!less(p, chunk) && less(p, chunk + slotSize * stats.chunkCapacity)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+std::vector<EntityPoolStats> GetEntityPoolStats() {
+	return {
+		{% for entity in entities %}
+			{{entity.get_type_name()}}::GetPoolStats(),
+		{% endfor %}
+	};
+}
+
 // /////////////// //
 // Message helpers //
 // /////////////// //
@@ -177,6 +269,9 @@ bool Entity::SendMessage(EntityMessage msg, const void* data) {
 		{% endfor %}
 	};
 
+	// {{entity.get_type_name()}}'s allocation pool.
+	EntityPool {{entity.get_type_name()}}::pool("{{entity.get_type_name()}}", sizeof({{entity.get_type_name()}}), {{general.pool_chunk_size}});
+
 	// {{entity.get_type_name()}}'s constructor.
 	{% set user_params = entity.get_user_params() %}
 	{{entity.get_type_name()}}::{{entity.get_type_name()}}(Params params)
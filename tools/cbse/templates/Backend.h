@@ -58,7 +58,9 @@
 #ifndef CBSE_BACKEND_H_
 #define CBSE_BACKEND_H_
 
+#include <cstddef>
 #include <set>
+#include <vector>
 
 #define CBSE_INCLUDE_TYPES_ONLY
 #include "../{{files['helper']}}"
@@ -184,6 +186,67 @@ class Entity {
 		{% endfor %}
 };
 
+// //////////// //
+// Entity pools //
+// //////////// //
+
+/** Allocation statistics of the pool of a specific entity type. */
+struct EntityPoolStats {
+	const char* name;          /**< Name of the entity type. */
+	size_t objectSize;         /**< Size of a pool slot. */
+	size_t chunkCapacity;      /**< Number of slots allocated at once. */
+	size_t chunks;             /**< Number of chunks allocated so far. */
+	size_t live;               /**< Objects currently allocated. */
+	size_t peak;               /**< Highest number of live objects. */
+	size_t allocations;        /**< Total number of allocations. */
+	size_t recycled;           /**< Allocations served from a freed slot. */
+	size_t overflows;          /**< Allocations that did not fit a slot and used the heap. */
+};
+
+/**
+ * @brief Fixed size slot allocator backing the operator new of a specific entity.
+ *
+ * Slots are carved out of chunks of a fixed capacity, so that entities of the same
+ * type (and the components they embed) end up next to each other in memory. Freed
+ * slots are kept on a free list and reused by the next allocation; chunks are only
+ * released when the pool is destroyed.
+ */
+class EntityPool {
+	public:
+		EntityPool(const char* name, size_t objectSize, size_t chunkCapacity);
+		~EntityPool();
+
+		EntityPool(const EntityPool&) = delete;
+		EntityPool& operator=(const EntityPool&) = delete;
+
+		/** Returns storage for an object of the given size. */
+		void* Allocate(size_t size);
+
+		/** Gives back storage obtained from Allocate. */
+		void Free(void* ptr);
+
+		/** Allocation statistics of this pool. */
+		const EntityPoolStats& GetStats() const {
+			return stats;
+		}
+
+	private:
+		struct FreeSlot {
+			FreeSlot* next;
+		};
+
+		bool Owns(const void* ptr) const;
+
+		size_t slotSize;
+		std::vector<char*> chunks;
+		size_t chunkUsed;
+		FreeSlot* freeList;
+		EntityPoolStats stats;
+};
+
+/** Returns the allocation statistics of every specific entity type. */
+std::vector<EntityPoolStats> GetEntityPoolStats();
+
 // ////////////////////////// //
 // Base component definitions //
 // ////////////////////////// //
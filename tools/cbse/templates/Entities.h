@@ -74,6 +74,21 @@
 			/** Default destructor of {{entity.get_type_name()}}. */
 			virtual ~{{entity.get_type_name()}}() = default;
 
+			/** Allocates {{entity.get_type_name()}} instances from its pool. */
+			static void* operator new(size_t size) {
+				return pool.Allocate(size);
+			}
+
+			/** Returns {{entity.get_type_name()}} instances to its pool. */
+			static void operator delete(void* ptr) {
+				pool.Free(ptr);
+			}
+
+			/** Allocation statistics of {{entity.get_type_name()}}. */
+			static const EntityPoolStats& GetPoolStats() {
+				return pool.GetStats();
+			}
+
 			{% for component in entity.get_components() %}
 				{{component.get_type_name()}} {{component.get_variable_name()}}; /**< {{entity.get_type_name()}}'s {{component.get_type_name()}} instance. */
 			{% endfor %}
@@ -84,6 +99,9 @@
 
 			/** {{entity.get_type_name()}}'s component offset table. */
 			static const int componentOffsets[];
+
+			/** {{entity.get_type_name()}}'s allocation pool. */
+			static EntityPool pool;
 	};
 
 {% endfor %}
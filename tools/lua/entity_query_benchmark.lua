@@ -0,0 +1,107 @@
+--[[
+===========================================================================
+
+Unvanquished BSD Source Code
+Copyright (c) 2026, Unvanquished Developers
+All rights reserved.
+
+This file is part of the Unvanquished BSD Source Code (Unvanquished Source Code).
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Unvanquished developers nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL DAEMON DEVELOPERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+===========================================================================
+]]
+
+-- Times Entities.query against equivalent filtering done in Lua.
+-- This is not shipped with the game. Copy it to the game directory of the server's
+-- home path and run it on a populated map: /lua -f lua/entity_query_benchmark.lua
+
+local ITERATIONS = 200
+
+local function bench(name, fn)
+	local start = os.clock()
+	local count = 0
+	for _ = 1, ITERATIONS do
+		count = fn()
+	end
+	local elapsed = (os.clock() - start) * 1000
+	print(string.format("%-32s %6d entities %9.3f ms/query", name, count, elapsed / ITERATIONS))
+end
+
+-- Baseline: fetch everything with its fields and filter in Lua, as a script
+-- without dedicated filters would have to. Like the C++ filter, it measures the
+-- distance to the entity's bounds, not to its origin.
+local function luaFilter(team, origin, radius)
+	local all = Entities.query({ fields = { "team", "absmin", "absmax", "health" } })
+	local count = 0
+	for i = 1, all.count do
+		if all.team[i] == team then
+			local o = 3 * (i - 1)
+			local distanceSquared = 0
+			for j = 1, 3 do
+				local low, high = all.absmin[o + j], all.absmax[o + j]
+				if origin[j] < low then
+					distanceSquared = distanceSquared + (low - origin[j]) ^ 2
+				elseif origin[j] > high then
+					distanceSquared = distanceSquared + (origin[j] - high) ^ 2
+				end
+			end
+			if distanceSquared <= radius * radius then
+				count = count + 1
+			end
+		end
+	end
+	return count
+end
+
+local all = Entities.query({ fields = { "origin" } })
+local center = { 0, 0, 0 }
+if all.count > 0 then
+	center = { all.origin[1], all.origin[2], all.origin[3] }
+end
+
+bench("all", function()
+	return Entities.query().count
+end)
+
+bench("buildables, health", function()
+	return Entities.query({ kind = "buildable", fields = { "health" } }).count
+end)
+
+bench("humans, alive, team+origin", function()
+	return Entities.query({ team = "humans", alive = true, fields = { "team", "origin" } }).count
+end)
+
+bench("radius 1000 (C++)", function()
+	return Entities.query({ team = "aliens", origin = center, radius = 1000, fields = { "health" } }).count
+end)
+
+bench("radius 1000 (Lua filter)", function()
+	return luaFilter("aliens", center, 1000)
+end)
+
+bench("box 2000", function()
+	return Entities.query({
+		mins = { center[1] - 1000, center[2] - 1000, center[3] - 1000 },
+		maxs = { center[1] + 1000, center[2] + 1000, center[3] + 1000 },
+	}).count
+end)